@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT OR Apache-2.0
+"""Build the receiver with each optimization profile and compare them.
+
+For every board and profile the receiver is built with west into
+build/profiles/<board>/<profile>, and the flash and RAM use of zephyr.elf is
+printed next to the flash available to the application.
+
+ISR timing is measured on hardware: build with CONFIG_ISR_PROFILE=y added to
+the profile (--isr-profile), flash the board, let trackers run for a while and
+save the output of the "profile show" shell command to a file. Pass the files
+with --timing profile=file and the mean and max cycles of the ESB event handler
+and radio timer handler are added to the report.
+
+The recommended profile for a board is the fastest one (by measured event
+handler cycles, or by the order of PROFILES without measurements) that leaves
+at least --headroom percent of the application flash free. Pass it to west
+with -DEXTRA_CONF_FILE after receiver.conf, the release builds take theirs from
+the board matrix in .github/workflows/workflow.yml.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# fastest first
+PROFILES = {
+    "speed-lto": ["overlay-speed.conf", "overlay-lto.conf"],
+    "speed": ["overlay-speed.conf"],
+    "default": [],
+    "size-lto": ["overlay-size.conf", "overlay-lto.conf"],
+    "size": ["overlay-size.conf"],
+}
+
+TIMING_POINTS = ("esb event", "timer")  # names in "profile show"
+
+
+def build(app, board, profile, isr_profile, board_root, verbose):
+    build_dir = os.path.join(app, "build", "profiles", board.replace("/", "_"), profile)
+    confs = ["receiver.conf"] + PROFILES[profile]
+    cmd = ["west", "build", "--board", board, "--pristine=always", "--build-dir", build_dir, app, "--",
+           "-DNCS_TOOLCHAIN_VERSION=NONE", "-DRECEIVER=ON"]
+    if board_root:
+        cmd.append(f"-DBOARD_ROOT={board_root}")
+    cmd.append("-DEXTRA_CONF_FILE=" + ";".join(confs))
+    if isr_profile:
+        cmd.append("-DCONFIG_ISR_PROFILE=y")
+    print(" ".join(cmd), file=sys.stderr)
+    result = subprocess.run(cmd, stdout=None if verbose else subprocess.DEVNULL)
+    if result.returncode:
+        return None
+    # sysbuild puts the application image in a subdirectory named after it
+    for sub in (os.path.basename(os.path.abspath(app)), ""):
+        zephyr = os.path.join(build_dir, sub, "zephyr")
+        if os.path.exists(os.path.join(zephyr, "zephyr.elf")):
+            return zephyr
+    return None
+
+
+def elf_size(zephyr, size_tool):
+    out = subprocess.run([size_tool, os.path.join(zephyr, "zephyr.elf")],
+                         capture_output=True, text=True, check=True).stdout
+    text, data, bss = (int(v) for v in out.splitlines()[1].split()[:3])
+    return text + data, data + bss
+
+
+def flash_available(zephyr):
+    config = {}
+    with open(os.path.join(zephyr, ".config")) as f:
+        for line in f:
+            m = re.match(r"CONFIG_(\w+)=(.*)", line.strip())
+            if m:
+                config[m.group(1)] = m.group(2)
+    size = int(config.get("FLASH_SIZE", "0")) * 1024
+    offset = int(config.get("FLASH_LOAD_OFFSET", "0"), 0)
+    load_size = int(config.get("FLASH_LOAD_SIZE", "0"), 0)
+    return load_size if load_size else size - offset
+
+
+def read_timing(path):
+    """Parse "profile show" output: name count min mean max"""
+    timing = {}
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = re.match(r"\s*(.*?)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s*$", line)
+            if m and m.group(1) in TIMING_POINTS:
+                timing[m.group(1)] = (int(m.group(4)), int(m.group(5)))
+    return timing
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--board", action="append", required=True, help="board, may be repeated")
+    parser.add_argument("--profile", action="append", choices=PROFILES, help="profile, may be repeated (default: all)")
+    parser.add_argument("--app", default=os.path.join(os.path.dirname(__file__), ".."))
+    parser.add_argument("--board-root", help="passed as BOARD_ROOT, for the boards in this repository")
+    parser.add_argument("--size-tool", default="arm-zephyr-eabi-size")
+    parser.add_argument("--headroom", type=float, default=10, help="flash to keep free (percent)")
+    parser.add_argument("--isr-profile", action="store_true", help="build with CONFIG_ISR_PROFILE=y")
+    parser.add_argument("--timing", action="append", default=[], metavar="PROFILE=FILE",
+                        help="\"profile show\" output measured with this profile")
+    parser.add_argument("--verbose", action="store_true")
+    args = parser.parse_args()
+
+    profiles = args.profile or list(PROFILES)
+    timing = {}
+    for entry in args.timing:
+        name, path = entry.split("=", 1)
+        timing[name] = read_timing(path)
+
+    for board in args.board:
+        print(f"{board}:")
+        print(f"  {'profile':<10} {'flash':>8} {'ram':>8} {'free':>6} {'event mean':>10} {'max':>6} {'timer mean':>10} {'max':>6}")
+        fits = []
+        for profile in profiles:
+            zephyr = build(args.app, board, profile, args.isr_profile, args.board_root, args.verbose)
+            if not zephyr:
+                print(f"  {profile:<10} build failed")
+                continue
+            flash, ram = elf_size(zephyr, args.size_tool)
+            available = flash_available(zephyr)
+            free = 100 * (available - flash) / available if available else 0
+            cycles = []
+            for point in TIMING_POINTS:
+                mean, peak = timing.get(profile, {}).get(point, (None, None))
+                cycles += [f"{mean:>10}" if mean is not None else f"{'-':>10}", f"{peak:>6}" if peak is not None else f"{'-':>6}"]
+            print(f"  {profile:<10} {flash:>8} {ram:>8} {free:>5.1f}% " + " ".join(cycles))
+            if free >= args.headroom:
+                fits.append(profile)
+        if not fits:
+            print("  no profile leaves enough flash free")
+            continue
+        measured = [p for p in fits if "esb event" in timing.get(p, {})]
+        if measured:
+            best = min(measured, key=lambda p: timing[p]["esb event"][0])
+        else:
+            best = fits[0]  # PROFILES is ordered fastest first
+        print(f"  recommended: {best} ({';'.join(PROFILES[best]) or 'no overlay'})")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT OR Apache-2.0
+"""Simulate the time to move all trackers to a new channel.
+
+The receiver announces the new channel in the sync beacon of every frame for
+--countdown frames, then switches (esb_migrate_channel, see esb.h). A tracker
+that receives at least one announcing beacon switches with the receiver. A
+tracker that misses all of them loses the receiver and searches: it listens on
+each of --search-channels channels for --dwell ms in turn, starting at a random
+one, until it hears a beacon on the new channel.
+
+Beacons on the old channel are lost with --loss (the interference that started
+the move), beacons on the new channel with --new-loss. Each run prints the
+time until all trackers are on the new channel, counted from the first
+announcement, and how many trackers had to search. Percentiles over --runs.
+"""
+
+import argparse
+import random
+
+
+def simulate(args, rng):
+    frame_ms = args.frame_ms
+    switch = args.countdown + 1  # frames until the receiver switches
+    done = []
+    searched = 0
+    for _ in range(args.trackers):
+        heard = any(rng.random() >= args.loss for _ in range(switch))
+        if heard:
+            done.append(switch * frame_ms)
+            continue
+        searched += 1
+        # searching starts after the tracker notices the missing beacons
+        t = switch * frame_ms + args.timeout
+        channel = rng.randrange(args.search_channels)
+        while True:
+            if channel == 0:  # the new channel
+                frames = int(args.dwell / frame_ms)
+                hit = next((i for i in range(frames) if rng.random() >= args.new_loss), None)
+                if hit is not None:
+                    t += (hit + 1) * frame_ms
+                    break
+            t += args.dwell
+            channel = (channel + 1) % args.search_channels
+        done.append(t)
+    return max(done), searched
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--trackers", type=int, default=10)
+    parser.add_argument("--countdown", type=int, default=100, help="announcing frames (CHANNEL_SCAN_MIGRATE_FRAMES)")
+    parser.add_argument("--frame-ms", type=float, default=3)
+    parser.add_argument("--loss", type=float, default=0.5, help="beacon loss on the old channel")
+    parser.add_argument("--new-loss", type=float, default=0.05, help="beacon loss on the new channel")
+    parser.add_argument("--timeout", type=float, default=100, help="ms without beacons before a tracker searches")
+    parser.add_argument("--search-channels", type=int, default=45, help="channels a lost tracker searches")
+    parser.add_argument("--dwell", type=float, default=15, help="ms a searching tracker listens per channel")
+    parser.add_argument("--runs", type=int, default=1000)
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    times = []
+    searches = []
+    for _ in range(args.runs):
+        t, searched = simulate(args, rng)
+        times.append(t)
+        searches.append(searched)
+    print(f"{args.trackers} trackers, {args.countdown} frame countdown, {args.loss:.0%} beacon loss on the old channel")
+    print(f"all trackers moved: p50 {percentile(times, 50):.0f} ms, p90 {percentile(times, 90):.0f} ms, "
+          f"p99 {percentile(times, 99):.0f} ms, max {max(times):.0f} ms")
+    print(f"runs with a searching tracker: {sum(1 for s in searches if s) / args.runs:.1%}, "
+          f"trackers searching per run: mean {sum(searches) / args.runs:.3f}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT OR Apache-2.0
+"""Simulate per tracker delivered rates when the HID link is saturated.
+
+Trackers send packets at fixed rates with some jitter. The HID link takes at
+most --capacity packets per second. Packets that do not fit are held back by
+the forwarding stage (src/connection/forward.c), where a newer packet from the
+same tracker replaces the held one. Held packets are forwarded either in
+arrival order or in weighted fair order (self-clocked fair queuing with the
+per tracker weights), and the delivered rate of each tracker is printed for
+both.
+
+Trackers are given as rate:weight, for example the default is a head and hip
+tracker with weight 8 and eight limb trackers at a higher rate with weight 2.
+"""
+
+import argparse
+import heapq
+import random
+
+VTIME_SCALE = 0x10000
+
+
+def simulate(trackers, capacity, seconds, fair, jitter):
+    events = []
+    for imu_id, (rate, _) in enumerate(trackers):
+        heapq.heappush(events, (random.uniform(0, 1 / rate), imu_id))
+    held = []  # imu_id in order of arrival, one per tracker
+    delivered = [0] * len(trackers)
+    tracker_vtime = [0] * len(trackers)
+    vtime = 0
+    next_slot = 0.0
+    slot = 1 / capacity
+    while True:
+        time, imu_id = heapq.heappop(events)
+        if time > seconds:
+            break
+        # forward held packets for every slot that passed before this arrival
+        while held and next_slot <= time:
+            if fair:
+                tags = [max(tracker_vtime[i], vtime) + VTIME_SCALE // trackers[i][1] for i in held]
+                n = min(range(len(held)), key=lambda k: (tags[k], k))
+                tracker_vtime[held[n]] = vtime = tags[n]
+            else:
+                n = 0
+            delivered[held.pop(n)] += 1
+            next_slot += slot
+        if not held and next_slot < time:
+            next_slot = time
+        if imu_id not in held:
+            held.append(imu_id)
+        rate = trackers[imu_id][0]
+        heapq.heappush(events, (time + random.gauss(1 / rate, jitter / rate), imu_id))
+    return [d / seconds for d in delivered]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("trackers", nargs="*", default=["100:8"] * 2 + ["200:2"] * 8, help="rate:weight per tracker")
+    parser.add_argument("--capacity", type=float, default=600, help="hid packets per second")
+    parser.add_argument("--seconds", type=float, default=20)
+    parser.add_argument("--jitter", type=float, default=0.05, help="send interval jitter, fraction of the interval")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    trackers = [tuple(float(v) for v in t.split(":")) for t in args.trackers]
+    trackers = [(rate, int(weight)) for rate, weight in trackers]
+    offered = sum(rate for rate, _ in trackers)
+    print(f"offered {offered:.0f} packets/s, capacity {args.capacity:.0f} packets/s")
+
+    random.seed(args.seed)
+    arrival = simulate(trackers, args.capacity, args.seconds, False, args.jitter)
+    random.seed(args.seed)
+    fair = simulate(trackers, args.capacity, args.seconds, True, args.jitter)
+
+    print(f"{'id':>3} {'rate':>6} {'weight':>6} {'arrival':>8} {'fair':>8}  (packets/s)")
+    for imu_id, (rate, weight) in enumerate(trackers):
+        print(f"{imu_id:>3} {rate:>6.0f} {weight:>6} {arrival[imu_id]:>8.1f} {fair[imu_id]:>8.1f}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT OR Apache-2.0
+"""Compare the fixed 3 ms frame with the adaptive frame period across tracker counts.
+
+Each frame has a tx window of two slots around the frame start (sync beacon,
+commands) and an rx window for the rest. Trackers send a packet per sample at
+--rate with some jitter. A packet that would start in the tx window waits for
+the rx window. Packets that overlap on air collide and are retried after the
+ESB retransmit delay, up to --retransmits times, then lost.
+
+For every tracker count the period of both policies is printed with the
+delivered share of packets, uplink latency (sample to reception, mean and p99)
+and downlink latency (mean wait for the next sync beacon or command slot,
+half a frame). The adaptive period uses the same formula as
+timer_adapt_period() in src/connection/timer.c.
+"""
+
+import argparse
+import heapq
+import random
+
+SLOT_US = 281  # tx slot before and after the frame start, esb_tx_slot() for the default profile
+PACKET_AIRTIME = 250  # us per packet and ack, TIMER_PACKET_AIRTIME
+HEADROOM = 2
+RX_MAX_PERMILLE = 950
+PERIOD_STEP = 250
+
+
+def adapt_period(packet_rate, airtime, tx_window, minimum, maximum):
+    rx_permille = min(packet_rate * airtime * HEADROOM // 1000, RX_MAX_PERMILLE)
+    period = tx_window * 1000 // (1000 - rx_permille)
+    period = -(-period // PERIOD_STEP) * PERIOD_STEP
+    return max(minimum, min(maximum, period))
+
+
+def rx_start(t, period):
+    """Earliest time from t outside the tx window [period - slot, period + slot) of each frame"""
+    phase = t % period
+    if phase < SLOT_US:
+        return t - phase + SLOT_US
+    if phase >= period - SLOT_US:
+        return t - phase + period + SLOT_US
+    return t
+
+
+def simulate(trackers, period, args, rng):
+    interval = 1e6 / args.rate
+    attempts = []  # (time, tracker, sample time, retries)
+    for tracker in range(trackers):
+        t = rng.uniform(0, interval)
+        while t < args.seconds * 1e6:
+            attempts.append((t + rng.uniform(-args.jitter, args.jitter), tracker, t, 0))
+            t += interval
+    heapq.heapify(attempts)
+    delivered = []
+    lost = 0
+    on_air = None  # [end, tracker, sample, retries, collided]
+
+    def failed(t, tracker, sample, retries):
+        nonlocal lost
+        if retries < args.retransmits:
+            heapq.heappush(attempts, (t + args.retransmit_delay, tracker, sample, retries + 1))
+        else:
+            lost += 1
+
+    def finish(packet):
+        end, tracker, sample, retries, collided = packet
+        if collided:
+            failed(end - PACKET_AIRTIME, tracker, sample, retries)
+        else:
+            delivered.append(end - sample)
+
+    while attempts:
+        t, tracker, sample, retries = heapq.heappop(attempts)
+        start = rx_start(t, period)
+        if start != t:  # wait for the rx window
+            heapq.heappush(attempts, (start, tracker, sample, retries))
+            continue
+        if on_air and t < on_air[0]:  # overlaps the packet on air, both are lost
+            on_air[4] = True
+            on_air[0] = max(on_air[0], t + PACKET_AIRTIME)
+            failed(t, tracker, sample, retries)
+            continue
+        if on_air:
+            finish(on_air)
+        on_air = [t + PACKET_AIRTIME, tracker, sample, retries, False]
+    if on_air:
+        finish(on_air)
+    return delivered, lost
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100))] if values else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--trackers", default="1,2,4,6,8,10,12,16,20", help="tracker counts")
+    parser.add_argument("--rate", type=float, default=200, help="packets per second per tracker")
+    parser.add_argument("--jitter", type=float, default=200, help="send jitter (+/- us)")
+    parser.add_argument("--retransmits", type=int, default=3)
+    parser.add_argument("--retransmit-delay", type=float, default=600, help="us")
+    parser.add_argument("--min", type=int, default=1500, help="CONFIG_RX_ADAPTIVE_FRAME_MIN")
+    parser.add_argument("--max", type=int, default=6000, help="CONFIG_RX_ADAPTIVE_FRAME_MAX")
+    parser.add_argument("--seconds", type=float, default=2)
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    print(f"{'trackers':>8} {'policy':>8} {'period':>7} {'rx %':>5} {'delivered':>9} {'up mean':>8} {'up p99':>7} {'down':>6}")
+    for trackers in (int(n) for n in args.trackers.split(",")):
+        adaptive = adapt_period(int(trackers * args.rate), PACKET_AIRTIME, 2 * SLOT_US, args.min, args.max)
+        for policy, period in (("fixed", 3000), ("adaptive", adaptive)):
+            rng = random.Random(args.seed)
+            delivered, lost = simulate(trackers, period, args, rng)
+            sent = len(delivered) + lost
+            share = len(delivered) / sent if sent else 0
+            mean = sum(delivered) / len(delivered) if delivered else 0
+            print(f"{trackers:>8} {policy:>8} {period:>7} {100 - 200 * SLOT_US / period:>5.1f} {share:>9.1%} "
+                  f"{mean:>8.0f} {percentile(delivered, 99):>7.0f} {period / 2:>6.0f}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT OR Apache-2.0
+"""Decode dictionary logs (overlay-log-dictionary.conf) from a receiver.
+
+The receiver writes binary log records as hex to its console. The format
+strings and argument types are in build/zephyr/log_dictionary.json of the same
+build, so the records are small and ISRs only copy their arguments.
+
+file:   decode a saved console log, lines that are not hex are skipped
+serial: read the console from a serial port until Ctrl-C, then decode
+
+Decoding uses the dictionary log parser of Zephyr
+(scripts/logging/dictionary in ZEPHYR_BASE).
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+HEX = set("0123456789abcdefABCDEF")
+
+
+def find_dictionary(build):
+    for path in (os.path.join(build, "zephyr", "log_dictionary.json"),
+                 os.path.join(build, os.path.basename(os.path.abspath(os.path.join(build, ".."))), "zephyr", "log_dictionary.json")):
+        if os.path.exists(path):
+            return path
+    for root, _, files in os.walk(build):  # sysbuild puts the application in a subdirectory
+        if "log_dictionary.json" in files:
+            return os.path.join(root, "log_dictionary.json")
+    raise SystemExit(f"no log_dictionary.json in {build}, build with overlay-log-dictionary.conf")
+
+
+def parser_path():
+    base = os.environ.get("ZEPHYR_BASE")
+    if not base:
+        raise SystemExit("ZEPHYR_BASE is not set")
+    return os.path.join(base, "scripts", "logging", "dictionary", "log_parser.py")
+
+
+def hex_only(lines):
+    """Keep the hex log stream, drop shell prompts and other text"""
+    return "".join(line.strip() for line in lines if line.strip() and set(line.strip()) <= HEX)
+
+
+def decode(dictionary, data):
+    with tempfile.NamedTemporaryFile("w", suffix=".hex", delete=False) as f:
+        f.write(data)
+        path = f.name
+    try:
+        subprocess.run([sys.executable, parser_path(), "--hex", dictionary, path], check=False)
+    finally:
+        os.unlink(path)
+
+
+def cmd_file(args):
+    with open(args.log, errors="replace") as f:
+        decode(find_dictionary(args.build), hex_only(f))
+
+
+def cmd_serial(args):
+    import serial
+    dictionary = find_dictionary(args.build)
+    port = serial.Serial(args.port, timeout=0.1)
+    lines = []
+    print("Reading, press Ctrl-C to decode", file=sys.stderr)
+    try:
+        while True:
+            line = port.readline().decode(errors="replace")
+            if line:
+                lines.append(line)
+    except KeyboardInterrupt:
+        pass
+    if args.save:
+        with open(args.save, "w") as f:
+            f.writelines(lines)
+    decode(dictionary, hex_only(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--build", default="build", help="build directory of the running firmware")
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    p = sub.add_parser("file")
+    p.add_argument("log")
+    p.set_defaults(func=cmd_file)
+    p = sub.add_parser("serial")
+    p.add_argument("port")
+    p.add_argument("--save", help="also write the raw console output to a file")
+    p.set_defaults(func=cmd_serial)
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT OR Apache-2.0
+"""Measure the error of late sample prediction on a recorded HID capture.
+
+The capture has the same format as for rx_timing.py, one HID report per line:
+
+    <host time in us> <report bytes in hex>
+
+Orientation is read from tracker packets 1 and 4. For every tracker, runs of
+1 to --max packets are dropped in turn at each position of the stream, the
+prediction of src/connection/predict.c is run over the gap, and the angle
+between each predicted and the actual orientation is reported. Holding the last
+orientation, which is what the host does without prediction, is shown for
+comparison.
+
+With --export the orientation streams are written as a C header instead, which
+tests/predict runs through predict.c itself on native_sim.
+"""
+
+import argparse
+import math
+import sys
+from collections import defaultdict
+
+
+def read_orientation(path, raw=False):
+    """Return {imu_id: [(host time, (w, x, y, z))]}, with q15 values if raw."""
+    streams = defaultdict(list)
+    with open(path) as f:
+        for line in f:
+            parts = line.split()
+            if len(parts) < 2:
+                continue
+            host_time = int(parts[0])
+            data = bytes.fromhex("".join(parts[1:]))
+            for i in range(0, len(data) - 15, 16):
+                packet = data[i:i + 16]
+                if packet[0] not in (1, 4):
+                    continue
+                x, y, z, w = (int.from_bytes(packet[n:n + 2], "little", signed=True) for n in range(2, 10, 2))
+                if not raw:
+                    x, y, z, w = (v / 32768 for v in (x, y, z, w))
+                streams[packet[1]].append((host_time, (w, x, y, z)))
+    return streams
+
+
+def product(a, b):
+    aw, ax, ay, az = a
+    bw, bx, by, bz = b
+    return (aw * bw - ax * bx - ay * by - az * bz,
+            aw * bx + ax * bw + ay * bz - az * by,
+            aw * by - ax * bz + ay * bw + az * bx,
+            aw * bz + ax * by - ay * bx + az * bw)
+
+
+def normalize(q):
+    n = math.sqrt(sum(v * v for v in q)) or 1
+    return tuple(v / n for v in q)
+
+
+def angle(a, b):
+    delta = product(a, (b[0], -b[1], -b[2], -b[3]))
+    return math.degrees(2 * math.atan2(math.sqrt(sum(v * v for v in delta[1:])), abs(delta[0])))
+
+
+class Predictor:
+    """Same steps as predict_update and predict_sample."""
+
+    def __init__(self, timeout_us):
+        self.timeout_us = timeout_us
+        self.q = None
+        self.rate = (0, 0, 0)
+        self.last = 0
+        self.interval = 0
+
+    def update(self, time, q):
+        dt = time - self.last
+        if self.q is not None and 0 < dt < self.timeout_us:
+            conj = (self.q[0], -self.q[1], -self.q[2], -self.q[3])
+            delta = product(q, conj)
+            scale = (-1 if delta[0] < 0 else 1) / dt
+            self.rate = tuple(v * scale for v in delta[1:])
+            self.interval = self.interval + (dt - self.interval) // 8 if self.interval else dt
+        else:
+            self.rate = (0, 0, 0)
+            self.interval = 0
+        self.q = q
+        self.last = time
+
+    def sample(self, t):
+        return normalize(product((1.0, *(v * t for v in self.rate)), self.q))
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100))]
+
+
+def evaluate(stream, run, warmup, timeout_us):
+    predicted = []
+    held = []
+    for start in range(warmup, len(stream) - run):
+        predictor = Predictor(timeout_us)
+        for time, q in stream[start - warmup:start]:
+            predictor.update(time, q)
+        if not predictor.interval:
+            continue
+        for n in range(run):
+            actual = stream[start + n][1]
+            predicted.append(angle(predictor.sample(predictor.interval * (n + 1)), actual))
+            held.append(angle(predictor.q, actual))
+    return predicted, held
+
+
+def export(streams, path, source):
+    """C header for tests/predict, one array per tracker, time relative to its first packet."""
+    with open(path, "w") as f:
+        f.write(f"/* Generated by scripts/predict_eval.py --export from {source} */\n\n")
+        for imu_id in sorted(streams):
+            stream = streams[imu_id]
+            f.write(f"static const struct orientation_sample stream_{imu_id}[] = {{\n")
+            for time, (w, x, y, z) in stream:
+                f.write(f"\t{{{time - stream[0][0]}, {{{x}, {y}, {z}, {w}}}}},\n")
+            f.write("};\n\n")
+        f.write("static const struct orientation_stream streams[] = {\n")
+        for imu_id in sorted(streams):
+            f.write(f"\t{{stream_{imu_id}, ARRAY_SIZE(stream_{imu_id})}},\n")
+        f.write("};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture")
+    parser.add_argument("--max", type=int, default=3, help="longest run of dropped packets (CONFIG_RX_PREDICT_MAX)")
+    parser.add_argument("--warmup", type=int, default=16, help="packets before each gap")
+    parser.add_argument("--timeout", type=float, default=100, help="CONFIG_RX_PREDICT_TIMEOUT (ms)")
+    parser.add_argument("--export", metavar="HEADER", help="write the streams as a C header for tests/predict")
+    args = parser.parse_args()
+
+    streams = read_orientation(args.capture, raw=bool(args.export))
+    if not streams:
+        print("no orientation packets found", file=sys.stderr)
+        return 1
+    if args.export:
+        export(streams, args.export, args.capture.split("/")[-1])
+        return 0
+
+    print(f"{'id':>3} {'run':>3} {'samples':>8} {'predict p50':>11} {'p99':>6} {'hold p50':>8} {'p99':>6}  (deg)")
+    for imu_id in sorted(streams):
+        for run in range(1, args.max + 1):
+            predicted, held = evaluate(streams[imu_id], run, args.warmup, args.timeout * 1000)
+            if not predicted:
+                continue
+            print(f"{imu_id:>3} {run:>3} {len(predicted):>8} {percentile(predicted, 50):>11.2f} "
+                  f"{percentile(predicted, 99):>6.2f} {percentile(held, 50):>8.2f} {percentile(held, 99):>6.2f}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
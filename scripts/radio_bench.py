@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT OR Apache-2.0
+"""Benchmark radio profiles: throughput and loss against attenuation.
+
+There is no simulated radio channel for this receiver, so the benchmark runs on
+hardware with the tracker emulator (-DTRACKER_EMULATOR=ON) as the load. For
+each step build the emulator with the profile and TX power to test, e.g.
+    west build -- -DTRACKER_EMULATOR=ON -DEMU_PROFILE=2 -DEMU_TX_POWER=-20
+and add attenuators or distance as needed, then run
+    radio_bench.py run --port /dev/ttyACM0 --profile long_range --label "-20dBm 10m" results.csv
+
+run:    select the profile on the receiver ("trackers radio"), reset the counters,
+        wait, and append the forwarded rate and radio loss per tracker from
+        "trackers stats" and "trackers summary" to a CSV file
+report: print a table of throughput and loss per profile and step
+
+The emulator pairs with the default profile, the receiver announces the new
+profile to paired trackers in the sync beacon before it switches.
+"""
+
+import argparse
+import csv
+import os
+import re
+import sys
+import time
+
+PROFILES = ("default", "low_latency", "long_range", "ble_2m")  # enum esb_radio_profile
+FIELDS = ("profile", "label", "seconds", "trackers", "forwarded", "rate", "lost", "duplicates", "loss_percent")
+
+
+def run(args):
+    import serial  # pyserial
+
+    port = serial.Serial(args.port, args.baud, timeout=0.5)
+
+    def command(line, wait=0.5):
+        port.reset_input_buffer()
+        port.write(line.encode() + b"\r\n")
+        time.sleep(wait)
+        return port.read(port.in_waiting or 1).decode(errors="replace")
+
+    out = command("trackers radio " + args.profile)
+    if "Unknown" in out:
+        raise SystemExit(out)
+    time.sleep(args.settle)  # trackers follow the beacon, then the receiver switches
+    command("trackers reset")
+    time.sleep(args.seconds)
+    summary = command("trackers summary")
+    stats = command("trackers stats")
+
+    counters = {}
+    for line in summary.splitlines():
+        m = re.match(r"\s*([a-z ]+?)\s+(\d+)\s*$", line)
+        if m:
+            counters[m.group(1)] = int(m.group(2))
+    trackers = 0
+    for line in stats.splitlines():
+        fields = line.split()
+        if len(fields) >= 12 and fields[0].isdigit() and fields[4].isdigit() and int(fields[4]):
+            trackers += 1
+
+    forwarded = counters.get("hid forwarded", 0)
+    lost = counters.get("radio lost", 0)
+    duplicates = counters.get("duplicate dropped", 0)
+    row = {
+        "profile": args.profile,
+        "label": args.label,
+        "seconds": args.seconds,
+        "trackers": trackers,
+        "forwarded": forwarded,
+        "rate": round(forwarded / args.seconds, 1),
+        "lost": lost,
+        "duplicates": duplicates,
+        "loss_percent": round(100 * lost / (forwarded + lost), 2) if forwarded + lost else 0,
+    }
+    new = not os.path.exists(args.results)
+    with open(args.results, "a", newline="") as f:
+        writer = csv.DictWriter(f, FIELDS)
+        if new:
+            writer.writeheader()
+        writer.writerow(row)
+    print(", ".join(f"{k} {v}" for k, v in row.items()))
+
+
+def report(args):
+    with open(args.results, newline="") as f:
+        rows = list(csv.DictReader(f))
+    for profile in PROFILES:
+        steps = [r for r in rows if r["profile"] == profile]
+        if not steps:
+            continue
+        print(f"{profile}:")
+        print(f"  {'step':<20} {'trackers':>8} {'pkt/s':>8} {'loss %':>7} {'dups':>6}")
+        for r in steps:
+            print(f"  {r['label']:<20} {r['trackers']:>8} {r['rate']:>8} {r['loss_percent']:>7} {r['duplicates']:>6}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("run")
+    p.add_argument("results")
+    p.add_argument("--port", required=True, help="receiver shell serial port")
+    p.add_argument("--baud", type=int, default=115200)
+    p.add_argument("--profile", required=True, choices=PROFILES)
+    p.add_argument("--label", default="", help="attenuation or distance of this step")
+    p.add_argument("--seconds", type=float, default=30)
+    p.add_argument("--settle", type=float, default=3, help="wait after selecting the profile (s)")
+    p.set_defaults(func=run)
+    p = sub.add_parser("report")
+    p.add_argument("results")
+    p.set_defaults(func=report)
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT OR Apache-2.0
+"""Collect, inspect and replay ESB RX captures (CONFIG_RX_CAPTURE).
+
+extract: read a console log with "rxcap <hex>" lines (see src/connection/capture.h)
+         and write the records to a binary capture file
+info:    print packet counts and rates per imu_id of a capture file
+replay:  send a capture file to a receiver over its shell serial port, at the
+         original speed or faster, then print the receive path counters
+         ("trackers summary") so runs can be compared across commits
+
+Capture file: "RXC1" followed by the records, each is
+    0-3 time (us, little endian), 4 length, 5 pipe, 6 rssi, 7 pid, 8- payload
+The replaying receiver must have the same trackers stored as the captured one,
+or the packets are dropped by the filter.
+"""
+
+import argparse
+import sys
+import time
+from collections import defaultdict
+
+MAGIC = b"RXC1"
+HEADER_SIZE = 8
+
+
+def read_capture(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if not data.startswith(MAGIC):
+        raise SystemExit(f"{path}: not a capture file")
+    records = []
+    offset = len(MAGIC)
+    wraps = 0
+    last = None
+    while offset + HEADER_SIZE <= len(data):
+        length = data[offset + 4]
+        record = data[offset:offset + HEADER_SIZE + length]
+        offset += len(record)
+        t = int.from_bytes(record[0:4], "little")
+        if last is not None and t < last:
+            wraps += 1
+        last = t
+        records.append((t + (wraps << 32), record))
+    return records
+
+
+def extract(args):
+    count = 0
+    with open(args.log, errors="replace") as log, open(args.output, "wb") as out:
+        out.write(MAGIC)
+        for line in log:
+            index = line.find("rxcap ")
+            if index < 0:
+                continue
+            try:
+                record = bytes.fromhex(line[index + 6:].strip())
+            except ValueError:
+                continue
+            if len(record) < HEADER_SIZE or len(record) != HEADER_SIZE + record[4]:
+                continue
+            out.write(record)
+            count += 1
+    print(f"{count} records written to {args.output}")
+
+
+def info(args):
+    records = read_capture(args.capture)
+    if not records:
+        print("empty capture")
+        return
+    seconds = max((records[-1][0] - records[0][0]) / 1e6, 1e-6)
+    trackers = defaultdict(int)
+    other = defaultdict(int)
+    for _, record in records:
+        if record[4] == 16:
+            trackers[record[HEADER_SIZE + 1]] += 1
+        else:
+            other[record[4]] += 1
+    print(f"{len(records)} packets in {seconds:.1f} s, {len(records) / seconds:.0f} packets/s")
+    for length, count in sorted(other.items()):
+        print(f"  {count} packets of {length} bytes")
+    print(f"{'id':>3} {'packets':>8} {'pkt/s':>7}")
+    for imu_id, count in sorted(trackers.items()):
+        print(f"{imu_id:>3} {count:>8} {count / seconds:>7.1f}")
+
+
+def replay(args):
+    import serial  # pyserial
+
+    records = read_capture(args.capture)
+    port = serial.Serial(args.port, args.baud, timeout=0.5)
+
+    def command(line):
+        port.write(line.encode() + b"\r\n")
+
+    command("trackers reset")
+    time.sleep(0.5)
+    port.reset_input_buffer()
+    start = time.monotonic()
+    first = records[0][0] if records else 0
+    for t, record in records:
+        if args.speed > 0:
+            delay = (t - first) / 1e6 / args.speed - (time.monotonic() - start)
+            if delay > 0:
+                time.sleep(delay)
+        command("trackers replay " + record.hex())
+    elapsed = time.monotonic() - start
+    print(f"replayed {len(records)} packets in {elapsed:.1f} s")
+    time.sleep(0.5)
+    port.reset_input_buffer()
+    command("trackers summary")
+    time.sleep(0.5)
+    sys.stdout.write(port.read(port.in_waiting or 1).decode(errors="replace"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("extract")
+    p.add_argument("log")
+    p.add_argument("output")
+    p.set_defaults(func=extract)
+    p = sub.add_parser("info")
+    p.add_argument("capture")
+    p.set_defaults(func=info)
+    p = sub.add_parser("replay")
+    p.add_argument("capture")
+    p.add_argument("port")
+    p.add_argument("--baud", type=int, default=115200)
+    p.add_argument("--speed", type=float, default=1.0, help="replay speed factor, 0 for as fast as possible")
+    p.set_defaults(func=replay)
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT OR Apache-2.0
+"""Decode receiver RX timestamps from a HID capture and report per tracker jitter.
+
+The capture is a text file with one HID report per line:
+
+    <host time in us> <report bytes in hex>
+
+Reports are split into 16 byte packets. Timestamp packets (type 226, id 255,
+see src/connection/telemetry.h) carry the radio arrival time of forwarded
+tracker packets in the receiver clock. The receiver clock is mapped to the host
+clock with a linear fit on the lower envelope of host - receiver time, which is
+the path with the least USB delay.
+"""
+
+import argparse
+import statistics
+import sys
+from collections import defaultdict
+
+TELEMETRY_TIMESTAMP = 226
+TELEMETRY_ID = 255
+
+
+def read_capture(path):
+    with open(path) as f:
+        for line in f:
+            parts = line.split()
+            if len(parts) < 2:
+                continue
+            host_time = int(parts[0])
+            data = bytes.fromhex("".join(parts[1:]))
+            for i in range(0, len(data) - 15, 16):
+                yield host_time, data[i:i + 16]
+
+
+def decode_timestamps(capture):
+    """Return a list of (host time, imu_id, receiver time) with the receiver time unwrapped."""
+    events = []
+    last = None
+    wraps = 0
+    for host_time, packet in capture:
+        if packet[0] != TELEMETRY_TIMESTAMP or packet[1] != TELEMETRY_ID:
+            continue
+        count = min(packet[2], 3)
+        base = int.from_bytes(packet[3:7], "little")
+        if last is not None and base < last and last - base > 1 << 31:
+            wraps += 1
+        last = base
+        for n in range(count):
+            entry = packet[7 + n * 3:10 + n * 3]
+            offset = int.from_bytes(entry[1:3], "little")
+            events.append((host_time, entry[0], base + offset + (wraps << 32)))
+    return events
+
+
+def fit_clock(events, window_us):
+    """Fit host = rx * (1 + drift) + offset on the per window minimum of host - rx."""
+    minima = {}
+    for host_time, _, rx_time in events:
+        key = rx_time // window_us
+        delay = host_time - rx_time
+        if key not in minima or delay < minima[key][1]:
+            minima[key] = (rx_time, delay)
+    points = list(minima.values())
+    if len(points) < 2:
+        return 0.0, points[0][1] if points else 0
+    mean_x = statistics.fmean(x for x, _ in points)
+    mean_y = statistics.fmean(y for _, y in points)
+    var = sum((x - mean_x) ** 2 for x, _ in points)
+    drift = sum((x - mean_x) * (y - mean_y) for x, y in points) / var if var else 0.0
+    # shift down so the fit is a lower bound of the delay
+    offset = min(y - drift * x for x, y in points)
+    return drift, offset
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture")
+    parser.add_argument("--window", type=float, default=1.0, help="clock fit window in seconds")
+    args = parser.parse_args()
+
+    events = decode_timestamps(read_capture(args.capture))
+    if not events:
+        print("no timestamp packets found, is CONFIG_RX_TIMESTAMP enabled?", file=sys.stderr)
+        return 1
+
+    drift, offset = fit_clock(events, int(args.window * 1e6))
+    print(f"receiver clock: drift {drift * 1e6:+.1f} ppm, offset {offset:.0f} us")
+
+    delays = [host - (rx * (1 + drift) + offset) for host, _, rx in events]
+    print(f"usb delay above minimum: p50 {percentile(delays, 50):.0f} us, p99 {percentile(delays, 99):.0f} us")
+
+    arrivals = defaultdict(list)
+    for _, imu_id, rx_time in events:
+        arrivals[imu_id].append(rx_time)
+
+    print(f"{'id':>3} {'packets':>8} {'interval':>9} {'jitter':>8} {'p99 dev':>8} {'max gap':>8}  (us)")
+    for imu_id in sorted(arrivals):
+        times = sorted(arrivals[imu_id])
+        deltas = [b - a for a, b in zip(times, times[1:])]
+        if len(deltas) < 2:
+            continue
+        median = statistics.median(deltas)
+        deviation = [abs(d - median) for d in deltas]
+        print(f"{imu_id:>3} {len(times):>8} {median:>9.0f} {statistics.pstdev(deltas):>8.0f} "
+              f"{percentile(deviation, 99):>8.0f} {max(deltas):>8}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
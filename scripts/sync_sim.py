@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT OR Apache-2.0
+"""Simulate tracker sample alignment against the receiver sync beacon.
+
+The receiver sends a sync beacon at the start of every frame with the frame
+number and the receiver time of the frame start (see src/connection/esb.h).
+Each simulated tracker has its own crystal error and an unknown clock offset,
+and it sees each beacon with some timestamp jitter and loss.
+
+The tracker estimates its clock offset and drift against the receiver with a
+least squares fit over the last beacons. It then schedules its samples at a
+fixed phase in the receiver frame. The alignment error is the difference, in
+receiver time, between the instant a tracker actually sampled and the
+intended instant. The spread between trackers is what sensor fusion sees.
+"""
+
+import argparse
+import random
+import statistics
+from collections import deque
+
+
+class Tracker:
+    def __init__(self, ppm, offset, jitter_us, loss, history):
+        self.rate = 1 + ppm * 1e-6  # local seconds per receiver second
+        self.offset = offset  # local time at receiver time 0 (us)
+        self.jitter_us = jitter_us
+        self.loss = loss
+        self.beacons = deque(maxlen=history)  # (receiver time, local time)
+
+    def local(self, receiver_time):
+        return self.offset + receiver_time * self.rate
+
+    def receive(self, frame_time, delay_us):
+        if random.random() < self.loss:
+            return
+        # constant air and ramp-up delay cancels out, only jitter matters
+        local_time = self.local(frame_time + delay_us) + random.gauss(0, self.jitter_us)
+        self.beacons.append((frame_time, local_time - delay_us))
+
+    def estimate(self):
+        """Return (offset, rate) mapping receiver time to local time."""
+        if not self.beacons:
+            return None
+        if len(self.beacons) == 1:
+            t, l = self.beacons[0]
+            return l - t, 1.0
+        mean_t = statistics.fmean(t for t, _ in self.beacons)
+        mean_l = statistics.fmean(l for _, l in self.beacons)
+        var = sum((t - mean_t) ** 2 for t, _ in self.beacons)
+        rate = sum((t - mean_t) * (l - mean_l) for t, l in self.beacons) / var
+        return mean_l - rate * mean_t, rate
+
+    def sample_error(self, target):
+        """Receiver time error of a sample scheduled at the target receiver time."""
+        estimate = self.estimate()
+        if estimate is None:
+            return None
+        offset, rate = estimate
+        local_sample = offset + rate * target
+        actual = (local_sample - self.offset) / self.rate
+        return actual - target
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--trackers", type=int, default=10)
+    parser.add_argument("--frame", type=int, default=3000, help="frame period (us)")
+    parser.add_argument("--seconds", type=float, default=30)
+    parser.add_argument("--ppm", type=float, default=40, help="max crystal error of trackers")
+    parser.add_argument("--jitter", type=float, default=5, help="beacon timestamp jitter on the tracker (us)")
+    parser.add_argument("--loss", type=float, default=0.1, help="beacon loss rate")
+    parser.add_argument("--history", type=int, default=64, help="beacons used for the fit")
+    parser.add_argument("--phase", type=float, default=0.5, help="sample phase in the frame")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    random.seed(args.seed)
+    trackers = [
+        Tracker(random.uniform(-args.ppm, args.ppm), random.uniform(0, 1e6), args.jitter, args.loss, args.history)
+        for _ in range(args.trackers)
+    ]
+
+    frames = int(args.seconds * 1e6 / args.frame)
+    settle = frames // 10
+    errors = []
+    spreads = []
+    for frame in range(frames):
+        frame_time = frame * args.frame
+        for tracker in trackers:
+            tracker.receive(frame_time, 150)
+        if frame < settle:
+            continue
+        target = frame_time + args.phase * args.frame
+        frame_errors = [e for e in (t.sample_error(target) for t in trackers) if e is not None]
+        errors.extend(abs(e) for e in frame_errors)
+        if len(frame_errors) > 1:
+            spreads.append(max(frame_errors) - min(frame_errors))
+
+    print(f"{args.trackers} trackers, +-{args.ppm} ppm, {args.jitter} us jitter, {args.loss:.0%} beacon loss")
+    print(f"sample error:  p50 {percentile(errors, 50):6.2f} us  p99 {percentile(errors, 99):6.2f} us  max {max(errors):6.2f} us")
+    print(f"tracker spread: p50 {percentile(spreads, 50):6.2f} us  p99 {percentile(spreads, 99):6.2f} us  max {max(spreads):6.2f} us")
+
+
+if __name__ == "__main__":
+    main()
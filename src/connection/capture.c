@@ -0,0 +1,133 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/ring_buffer.h>
+
+#include "esb.h"
+#include "capture.h"
+
+#if CONFIG_RX_CAPTURE
+
+RING_BUF_DECLARE(capture_ring, CONFIG_RX_CAPTURE_BUFFER);
+static K_SEM_DEFINE(capture_pending, 0, 1);
+
+static bool capture_enabled;
+static uint32_t capture_overflow;
+
+LOG_MODULE_REGISTER(capture, LOG_LEVEL_INF);
+
+static void capture_thread(void);
+K_THREAD_DEFINE(capture_thread_id, 1024, capture_thread, NULL, NULL, NULL, 7, 0, 0);
+
+// Called from the radio ISR for each packet read from the RX FIFO
+void capture_rx(const struct esb_payload *payload)
+{
+	if (!capture_enabled)
+		return;
+	uint8_t header[CAPTURE_HEADER_SIZE];
+	if (ring_buf_space_get(&capture_ring) < sizeof(header) + payload->length)
+	{
+		capture_overflow++;
+		return;
+	}
+	sys_put_le32(k_ticks_to_us_floor64(k_uptime_ticks()), &header[0]);
+	header[4] = payload->length;
+	header[5] = payload->pipe;
+	header[6] = payload->rssi;
+	header[7] = payload->pid;
+	ring_buf_put(&capture_ring, header, sizeof(header));
+	ring_buf_put(&capture_ring, payload->data, payload->length);
+	k_sem_give(&capture_pending);
+}
+
+static bool capture_get(uint8_t *record)
+{
+	unsigned int key = irq_lock(); // the radio ISR writes to the ring buffer
+	bool got = ring_buf_get(&capture_ring, record, CAPTURE_HEADER_SIZE) == CAPTURE_HEADER_SIZE;
+	if (got)
+		ring_buf_get(&capture_ring, &record[CAPTURE_HEADER_SIZE], record[4]);
+	irq_unlock(key);
+	return got;
+}
+
+static void capture_thread(void)
+{
+	uint8_t record[CAPTURE_HEADER_SIZE + CONFIG_ESB_MAX_PAYLOAD_LENGTH];
+	char hex[sizeof(record) * 2 + 1];
+	while (1)
+	{
+		k_sem_take(&capture_pending, K_FOREVER);
+		while (capture_get(record))
+		{
+			bin2hex(record, CAPTURE_HEADER_SIZE + record[4], hex, sizeof(hex));
+			printk("rxcap %s\n", hex);
+		}
+		if (capture_overflow)
+		{
+			LOG_WRN("Capture overflow, %u packets lost", capture_overflow);
+			capture_overflow = 0;
+		}
+	}
+}
+
+#if CONFIG_SHELL
+static int cmd_trackers_capture(const struct shell *sh, size_t argc, char **argv)
+{
+	if (!strcmp(argv[1], "on"))
+		capture_enabled = true;
+	else if (!strcmp(argv[1], "off"))
+		capture_enabled = false;
+	else
+		return -EINVAL;
+	return 0;
+}
+
+static int cmd_trackers_replay(const struct shell *sh, size_t argc, char **argv)
+{
+	uint8_t record[CAPTURE_HEADER_SIZE + CONFIG_ESB_MAX_PAYLOAD_LENGTH];
+	size_t length = hex2bin(argv[1], strlen(argv[1]), record, sizeof(record));
+	if (length < CAPTURE_HEADER_SIZE || length != CAPTURE_HEADER_SIZE + record[4])
+	{
+		shell_error(sh, "Invalid record");
+		return -EINVAL;
+	}
+	struct esb_payload payload = {
+		.length = record[4],
+		.pipe = record[5],
+		.rssi = record[6],
+		.pid = record[7],
+	};
+	memcpy(payload.data, &record[CAPTURE_HEADER_SIZE], payload.length);
+	esb_replay(&payload);
+	return 0;
+}
+
+SHELL_SUBCMD_ADD((trackers), capture, NULL, "Print received packets to the console: on|off", cmd_trackers_capture, 2, 0);
+SHELL_SUBCMD_ADD((trackers), replay, NULL, "Run a captured record through the receive path: <hex>", cmd_trackers_replay, 2, 0);
+#endif
+
+#endif
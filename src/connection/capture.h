@@ -0,0 +1,47 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_CAPTURE
+#define SLIMENRF_CAPTURE
+
+#include <stdint.h>
+#include <esb.h>
+
+/*
+Capture of the ESB RX stream, printed to the console as one line per packet:
+
+rxcap <record in hex>
+
+Record, little endian: 0-3 time (us), 4 length, 5 pipe, 6 rssi, 7 pid, 8- payload
+scripts/rx_capture.py collects the lines into a binary file and replays it with the
+"trackers replay" shell command, which runs each record through the same path as the radio ISR.
+*/
+
+#define CAPTURE_HEADER_SIZE 8
+
+#if CONFIG_RX_CAPTURE
+void capture_rx(const struct esb_payload *payload);
+#else
+#define capture_rx(payload) ((void)0)
+#endif
+
+#endif
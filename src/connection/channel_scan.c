@@ -0,0 +1,246 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <hal/nrf_radio.h>
+
+#include "system/system.h"
+#include "system/retained.h"
+#include "esb.h"
+#include "stats.h"
+#include "channel_scan.h"
+
+#if CONFIG_ESB_CHANNEL_SCAN
+
+#define CHANNEL_SCAN_SAMPLES 8
+#define CHANNEL_SCAN_SAMPLE_SPACING 2 // us
+#define CHANNEL_SCAN_PER_FRAME 1 // channels scanned at the start of one rx window, about 70 us each in the radio timer ISR
+#define CHANNEL_SCAN_TIMEOUT 2000 // ms, CHANNEL_SCAN_COUNT frames of up to 20 ms
+#define CHANNEL_SCAN_INTERVAL 5000 // ms between loss checks
+#define CHANNEL_SCAN_HOLDOFF 30000 // ms after a move before the next rescan
+#define CHANNEL_SCAN_MIN_PACKETS 50 // per tracker and interval to judge its loss
+#define CHANNEL_SCAN_MIGRATE_FRAMES 100
+#define CHANNEL_SCAN_DEFAULT 2 // ESB driver default channel
+
+static uint8_t scan_rssi[CHANNEL_SCAN_COUNT]; // strongest signal seen (-dBm), higher is quieter
+static volatile int scan_next = -1; // next channel to scan from the radio timer, -1 if no scan is running
+static uint32_t scan_time; // us
+static uint8_t scan_buffer[64];
+
+static K_SEM_DEFINE(scan_done, 0, 1);
+static K_SEM_DEFINE(scan_request, 0, 1);
+
+static uint32_t last_packets[MAX_TRACKERS];
+static uint32_t last_lost[MAX_TRACKERS];
+
+LOG_MODULE_REGISTER(channel_scan, LOG_LEVEL_INF);
+
+static void channel_scan_thread(void);
+K_THREAD_DEFINE(channel_scan_thread_id, 1024, channel_scan_thread, NULL, NULL, NULL, 7, 0, 0);
+
+static inline int channel_scan_channel(int index)
+{
+	return CHANNEL_SCAN_FIRST + index * CHANNEL_SCAN_STEP;
+}
+
+static void radio_disable(void)
+{
+	NRF_RADIO->SHORTS = 0;
+	NRF_RADIO->EVENTS_DISABLED = 0;
+	NRF_RADIO->TASKS_DISABLE = 1;
+	while (NRF_RADIO->EVENTS_DISABLED == 0);
+	NRF_RADIO->EVENTS_DISABLED = 0;
+}
+
+// Strongest of CHANNEL_SCAN_SAMPLES RSSI samples, register access as in the listener (main.c)
+// Fast ramp up (40 us instead of 140 us) keeps the busy wait in the radio timer ISR short
+static uint8_t channel_scan_measure(int channel)
+{
+	uint8_t strongest = 127;
+	radio_disable();
+	uint32_t modecnf0 = NRF_RADIO->MODECNF0; // restored for ESB
+	NRF_RADIO->MODECNF0 = (modecnf0 & ~RADIO_MODECNF0_RU_Msk) | (RADIO_MODECNF0_RU_Fast << RADIO_MODECNF0_RU_Pos);
+	NRF_RADIO->FREQUENCY = channel;
+	NRF_RADIO->MODE = (RADIO_MODE_MODE_Nrf_2Mbit << RADIO_MODE_MODE_Pos);
+	NRF_RADIO->PACKETPTR = (uint32_t)scan_buffer;
+	NRF_RADIO->SHORTS = RADIO_SHORTS_READY_START_Msk;
+	NRF_RADIO->EVENTS_READY = 0;
+	NRF_RADIO->TASKS_RXEN = 1;
+	while (NRF_RADIO->EVENTS_READY == 0);
+	for (int i = 0; i < CHANNEL_SCAN_SAMPLES; i++)
+	{
+		NRF_RADIO->EVENTS_RSSIEND = 0;
+		NRF_RADIO->TASKS_RSSISTART = 1;
+		while (NRF_RADIO->EVENTS_RSSIEND == 0);
+		uint8_t rssi = NRF_RADIO->RSSISAMPLE;
+		if (rssi < strongest)
+			strongest = rssi;
+		k_busy_wait(CHANNEL_SCAN_SAMPLE_SPACING); // spread the samples over the channel dwell
+	}
+	radio_disable();
+	NRF_RADIO->MODECNF0 = modecnf0;
+	return strongest;
+}
+
+// Scan channels from index first, at most count, ESB must not be using the radio
+static int channel_scan_range(int first, int count)
+{
+	int end = MIN(first + count, CHANNEL_SCAN_COUNT);
+	uint32_t start = k_cycle_get_32();
+	NRF_RADIO->INTENCLR = 0xFFFFFFFF; // ESB enables its interrupts again on init
+	for (int i = first; i < end; i++)
+		scan_rssi[i] = channel_scan_measure(channel_scan_channel(i));
+	NRF_RADIO->EVENTS_READY = 0;
+	NRF_RADIO->EVENTS_END = 0;
+	NVIC_ClearPendingIRQ(RADIO_IRQn);
+	scan_time += k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	return end;
+}
+
+// Move to the quietest channel if it is quieter than the current one by the margin
+static bool channel_scan_select(void)
+{
+	int best = 0;
+	for (int i = 1; i < CHANNEL_SCAN_COUNT; i++)
+		if (scan_rssi[i] > scan_rssi[best])
+			best = i;
+	int channel = esb_get_channel();
+	if (channel < 0)
+		channel = CHANNEL_SCAN_DEFAULT;
+	int current = -1;
+	if (channel >= CHANNEL_SCAN_FIRST && channel <= CHANNEL_SCAN_LAST && (channel - CHANNEL_SCAN_FIRST) % CHANNEL_SCAN_STEP == 0)
+		current = (channel - CHANNEL_SCAN_FIRST) / CHANNEL_SCAN_STEP;
+	LOG_INF("Scanned %d channels in %u us, quietest %d (-%d dBm), current %d (%s%d dBm)", CHANNEL_SCAN_COUNT, scan_time,
+			channel_scan_channel(best), scan_rssi[best], channel, current < 0 ? "not scanned, " : "-", current < 0 ? 0 : scan_rssi[current]);
+	if (current == best || (current >= 0 && scan_rssi[best] < scan_rssi[current] + CONFIG_ESB_CHANNEL_SCAN_MARGIN))
+		return false;
+	LOG_INF("Moving from channel %d to %d", channel, channel_scan_channel(best));
+	esb_migrate_channel(channel_scan_channel(best), CHANNEL_SCAN_MIGRATE_FRAMES);
+	return true;
+}
+
+void channel_scan_boot(void)
+{
+	scan_time = 0;
+	channel_scan_range(0, CHANNEL_SCAN_COUNT);
+	channel_scan_select();
+}
+
+// Called from the radio timer between disabling ESB and starting the rx window
+void channel_scan_step(void)
+{
+	if (scan_next < 0)
+		return;
+	scan_next = channel_scan_range(scan_next, CHANNEL_SCAN_PER_FRAME);
+	if (scan_next == CHANNEL_SCAN_COUNT)
+	{
+		scan_next = -1;
+		k_sem_give(&scan_done);
+	}
+}
+
+// Keep the channel across reboots, also after a move by the coexistence mode
+static void channel_scan_store(void)
+{
+	int channel = esb_get_channel();
+	uint8_t stored = channel + 1; // 0 is the default channel
+	if (stored != retained->rf_channel)
+		sys_write(STORED_RF_CHANNEL, &retained->rf_channel, &stored, sizeof(stored));
+}
+
+// Count active trackers and those losing more than the threshold since the last check
+static void channel_scan_loss(int *active, int *degraded)
+{
+	struct tracker_stats tracker;
+	*active = 0;
+	*degraded = 0;
+	for (int i = 0; i < stored_trackers; i++)
+	{
+		stats_get_tracker(i, &tracker);
+		uint32_t packets = tracker.packets - last_packets[i];
+		uint32_t lost = tracker.lost - last_lost[i];
+		bool reset = tracker.packets < last_packets[i] || tracker.lost < last_lost[i]; // statistics were reset
+		last_packets[i] = tracker.packets;
+		last_lost[i] = tracker.lost;
+		if (reset || packets + lost < CHANNEL_SCAN_MIN_PACKETS)
+			continue;
+		(*active)++;
+		if (lost * 100 >= (packets + lost) * CONFIG_ESB_CHANNEL_SCAN_LOSS)
+			(*degraded)++;
+	}
+}
+
+static void channel_scan_thread(void)
+{
+	int64_t holdoff = 0;
+	int active, degraded;
+	while (1)
+	{
+		bool requested = !k_sem_take(&scan_request, K_MSEC(CHANNEL_SCAN_INTERVAL));
+		channel_scan_store();
+		channel_scan_loss(&active, &degraded);
+		if (!requested && (!degraded || degraded * 2 < active || k_uptime_get() < holdoff))
+			continue;
+		if (!requested)
+			LOG_WRN("%d/%d trackers losing packets, scanning channels", degraded, active);
+		k_sem_reset(&scan_done);
+		scan_time = 0;
+		scan_next = 0;
+		if (k_sem_take(&scan_done, K_MSEC(CHANNEL_SCAN_TIMEOUT))) // the radio timer is not running
+		{
+			scan_next = -1;
+			LOG_WRN("Channel scan not completed");
+			continue;
+		}
+		if (channel_scan_select())
+			holdoff = k_uptime_get() + CHANNEL_SCAN_HOLDOFF;
+	}
+}
+
+#if CONFIG_SHELL
+static int cmd_trackers_channels(const struct shell *sh, size_t argc, char **argv)
+{
+	if (argc == 2)
+	{
+		if (strcmp(argv[1], "scan"))
+		{
+			shell_error(sh, "Unknown argument %s", argv[1]);
+			return -EINVAL;
+		}
+		k_sem_give(&scan_request);
+		shell_print(sh, "Scan requested");
+		return 0;
+	}
+	int channel = esb_get_channel();
+	shell_print(sh, "Channel %d, last scan took %u us", channel < 0 ? CHANNEL_SCAN_DEFAULT : channel, scan_time);
+	for (int i = 0; i < CHANNEL_SCAN_COUNT; i++)
+		shell_print(sh, "%3d %4d dBm", channel_scan_channel(i), -scan_rssi[i]);
+	return 0;
+}
+
+SHELL_SUBCMD_ADD((trackers), channels, NULL, "Show the last channel scan or start one: [scan]", cmd_trackers_channels, 1, 1);
+#endif
+
+#endif
@@ -0,0 +1,51 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_CHANNEL_SCAN
+#define SLIMENRF_CHANNEL_SCAN
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+Channel selection from an RSSI energy scan
+Before RX starts all candidate channels are scanned with the radio registers directly, and the
+receiver moves to the quietest channel. While running, the per tracker loss is checked, and when
+most active trackers lose more than CONFIG_ESB_CHANNEL_SCAN_LOSS percent of their packets the
+channels are scanned again, one per frame in place of the start of the RX window. Trackers are
+moved through the sync beacon (esb_migrate_channel), the channel is stored in NVS.
+*/
+
+#define CHANNEL_SCAN_FIRST 2
+#define CHANNEL_SCAN_LAST 90
+#define CHANNEL_SCAN_STEP 2
+#define CHANNEL_SCAN_COUNT ((CHANNEL_SCAN_LAST - CHANNEL_SCAN_FIRST) / CHANNEL_SCAN_STEP + 1)
+
+#if CONFIG_ESB_CHANNEL_SCAN
+void channel_scan_boot(void); // before ESB is initialized, the HF clock must be running
+void channel_scan_step(void); // from the radio timer with ESB disabled, before RX starts
+#else
+#define channel_scan_boot() ((void)0)
+#define channel_scan_step() ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,294 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <esb.h>
+
+#include "esb.h"
+#include "timer.h"
+#include "coexist.h"
+
+#if CONFIG_ESB_COEXIST
+
+#define COEXIST_TIMEOUT 10000 // ms
+#define COEXIST_HOLDOFF 10000 // ms after a move, plus up to the same again at random
+#define COEXIST_MIGRATE_FRAMES 100
+
+struct coexist_neighbor {
+	uint32_t id;
+	uint32_t last_seen; // uptime (ms), zero if unused
+	uint16_t phase; // start of their frame in our frame (us)
+	uint16_t period;
+	uint16_t slot; // zero if not sent
+	uint8_t channel;
+};
+
+static struct coexist_neighbor neighbors[CONFIG_ESB_COEXIST_NEIGHBORS];
+
+static const uint8_t coexist_channels[] = {255, 10, 30, 50, 70, 90}; // 255 is the default channel
+
+static uint32_t own_id;
+static uint32_t rand_state;
+static uint32_t listen_frame;
+static uint32_t announce_frame;
+static uint32_t holdoff_until; // uptime (ms), no further moves before
+
+static struct esb_payload tx_payload_coexist = ESB_CREATE_PAYLOAD(0,
+														  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+LOG_MODULE_REGISTER(coexist, LOG_LEVEL_INF);
+
+static void coexist_thread(void);
+K_THREAD_DEFINE(coexist_thread_id, 768, coexist_thread, NULL, NULL, NULL, 7, 0, 0);
+
+static uint32_t coexist_rand(void) // xorshift, seeded from the address so receivers differ
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+static uint8_t coexist_channel(void)
+{
+	int channel = esb_get_channel();
+	return channel < 0 ? 255 : channel;
+}
+
+// Called from the radio timer at the start of each rx window
+enum coexist_frame coexist_frame_type(uint32_t frame)
+{
+	if (frame % CONFIG_ESB_COEXIST_INTERVAL == 0 && rand_state) // pick frames for the next interval
+	{
+		listen_frame = frame + 1 + coexist_rand() % (CONFIG_ESB_COEXIST_INTERVAL - 1);
+		announce_frame = frame + 1 + coexist_rand() % (CONFIG_ESB_COEXIST_INTERVAL - 1);
+		if (announce_frame == listen_frame)
+			announce_frame = 0;
+	}
+	if (frame == listen_frame)
+		return COEXIST_FRAME_LISTEN;
+	if (frame == announce_frame)
+		return COEXIST_FRAME_ANNOUNCE;
+	return COEXIST_FRAME_NORMAL;
+}
+
+// Called instead of the sync beacon in an announce frame
+void coexist_write_beacon(uint16_t frame_period, uint16_t slot)
+{
+	tx_payload_coexist.noack = true;
+	tx_payload_coexist.data[0] = COEXIST_MAGIC;
+	tx_payload_coexist.data[1] = 0;
+	sys_put_be32(own_id, &tx_payload_coexist.data[2]);
+	tx_payload_coexist.data[6] = coexist_channel();
+	tx_payload_coexist.data[7] = MIN(stored_trackers, 255);
+	sys_put_be16(frame_period, &tx_payload_coexist.data[8]);
+	sys_put_be16(slot, &tx_payload_coexist.data[10]);
+	esb_write_payload(&tx_payload_coexist);
+}
+
+// Called from the radio ISR for a beacon of another receiver
+void coexist_rx(const uint8_t *data)
+{
+	if (data[0] != COEXIST_MAGIC || data[1] != 0)
+		return;
+	uint32_t phase = timer_frame_offset(); // beacon is sent at the start of their frame
+	uint32_t id = sys_get_be32(&data[2]);
+	uint32_t now = k_uptime_get_32();
+	struct coexist_neighbor *slot = NULL;
+	for (int i = 0; i < CONFIG_ESB_COEXIST_NEIGHBORS; i++)
+	{
+		if (neighbors[i].last_seen && neighbors[i].id == id) // also after it moved to another channel
+		{
+			slot = &neighbors[i];
+			break;
+		}
+		if (!slot && (!neighbors[i].last_seen || now - neighbors[i].last_seen > COEXIST_TIMEOUT))
+			slot = &neighbors[i];
+	}
+	if (!slot)
+		return;
+	slot->id = id;
+	slot->last_seen = now ? now : 1;
+	slot->phase = phase;
+	slot->period = sys_get_be16(&data[8]);
+	slot->slot = sys_get_be16(&data[10]);
+	slot->channel = data[6];
+}
+
+// circular distance between two points in a frame
+static uint32_t coexist_distance(uint32_t a, uint32_t b, uint32_t period)
+{
+	uint32_t d = (a + period - b % period) % period;
+	return MIN(d, period - d);
+}
+
+static uint32_t coexist_gcd(uint32_t a, uint32_t b)
+{
+	while (b)
+	{
+		uint32_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+// Frame starts of a neighbor fall on every offset in our frame that matches its phase modulo the
+// gcd of both periods, so equal periods keep the phase and different periods cycle through them
+static uint32_t coexist_cycle(const struct coexist_neighbor *neighbor, uint32_t period)
+{
+	return coexist_gcd(period, neighbor->period);
+}
+
+// Closest approach of the tx slots with our frame start shifted by shift, negative if they overlap
+static int32_t coexist_gap(const struct coexist_neighbor *neighbor, uint32_t period, uint32_t slot, uint32_t shift)
+{
+	uint32_t their_slot = neighbor->slot ? neighbor->slot : slot;
+	return (int32_t)coexist_distance(neighbor->phase, shift, coexist_cycle(neighbor, period)) - (int32_t)(slot + their_slot);
+}
+
+// Whether some phase keeps the tx slots apart, otherwise they meet whatever the phase
+static bool coexist_separable(const struct coexist_neighbor *neighbor, uint32_t period, uint32_t slot)
+{
+	uint32_t their_slot = neighbor->slot ? neighbor->slot : slot;
+	return neighbor->period && coexist_cycle(neighbor, period) / 2 >= slot + their_slot;
+}
+
+// Wait for other receivers to see the move before the next one
+static void coexist_moved(uint32_t now, bool channel)
+{
+	unsigned int key = irq_lock(); // rand_state and neighbors are used from the radio ISRs
+	holdoff_until = now + COEXIST_HOLDOFF + coexist_rand() % COEXIST_HOLDOFF;
+	if (channel)
+		memset(neighbors, 0, sizeof(neighbors)); // neighbors on the new channel are heard again
+	irq_unlock(key);
+}
+
+static void coexist_evaluate(void)
+{
+	struct coexist_neighbor active[CONFIG_ESB_COEXIST_NEIGHBORS];
+	int count = 0;
+	uint32_t now = k_uptime_get_32();
+	unsigned int key = irq_lock(); // written from the radio ISR
+	for (int i = 0; i < CONFIG_ESB_COEXIST_NEIGHBORS; i++)
+		if (neighbors[i].last_seen && now - neighbors[i].last_seen <= COEXIST_TIMEOUT)
+			active[count++] = neighbors[i];
+	irq_unlock(key);
+
+	for (int i = 0; i < count; i++)
+		if (active[i].id == own_id)
+			LOG_WRN("Another receiver uses the same address, pair trackers to one of them only");
+
+	// Receivers on the same channel see the same neighbors, the one with the highest id moves and
+	// the others wait until its beacons show the new channel
+	if ((int32_t)(now - holdoff_until) < 0)
+		return;
+
+	// Move to the least used channel
+	uint8_t channel = coexist_channel();
+	int used[ARRAY_SIZE(coexist_channels)] = {0};
+	int own_used = 0;
+	bool yield = false;
+	for (int i = 0; i < count; i++)
+	{
+		if (active[i].channel == channel)
+		{
+			own_used++;
+			if (active[i].id > own_id)
+				yield = true;
+		}
+		for (int c = 0; c < ARRAY_SIZE(coexist_channels); c++)
+			if (active[i].channel == coexist_channels[c])
+				used[c]++;
+	}
+	if (!own_used)
+		return;
+	int best = -1;
+	for (int c = 0; c < ARRAY_SIZE(coexist_channels); c++)
+		if (coexist_channels[c] != 255 && (best < 0 || used[c] < used[best]))
+			best = c;
+	if (!yield && best >= 0 && used[best] < own_used)
+	{
+		LOG_INF("Moving from channel %d to %d, %d receivers on current channel", channel, coexist_channels[best], own_used);
+		esb_migrate_channel(coexist_channels[best], COEXIST_MIGRATE_FRAMES);
+		coexist_moved(now, true);
+		return;
+	}
+
+	// Stay on the channel, move the tx slot away from other receivers on it
+	uint32_t period = timer_frame_period();
+	uint32_t slot = timer_frame_slot();
+	if (!slot) // the radio timer is not running
+		return;
+	int32_t closest = INT32_MAX;
+	yield = false;
+	for (int i = 0; i < count; i++)
+	{
+		if (active[i].channel != channel || !coexist_separable(&active[i], period, slot))
+			continue;
+		int32_t gap = coexist_gap(&active[i], period, slot, 0);
+		closest = MIN(closest, gap);
+		if (gap < 0 && active[i].id > own_id) // that one moves
+			yield = true;
+	}
+	if (closest >= 0 || yield)
+		return;
+	uint32_t best_shift = 0;
+	int32_t best_gap = closest;
+	for (uint32_t shift = slot; shift < period; shift += slot)
+	{
+		int32_t gap = INT32_MAX;
+		for (int i = 0; i < count; i++)
+			if (active[i].channel == channel && coexist_separable(&active[i], period, slot))
+				gap = MIN(gap, coexist_gap(&active[i], period, slot, shift));
+		if (gap > best_gap)
+		{
+			best_gap = gap;
+			best_shift = shift;
+		}
+	}
+	if (!best_shift)
+		return;
+	LOG_INF("Shifting frame phase by %uus, tx slots overlapped by %dus", best_shift, -closest);
+	timer_shift_phase(best_shift);
+	key = irq_lock();
+	for (int i = 0; i < CONFIG_ESB_COEXIST_NEIGHBORS; i++)
+		neighbors[i].phase = (neighbors[i].phase + period - best_shift) % period;
+	irq_unlock(key);
+	coexist_moved(now, false);
+}
+
+static void coexist_thread(void)
+{
+	own_id = esb_addr_id();
+	rand_state = own_id ? own_id : 1;
+	while (1)
+	{
+		k_msleep(1000);
+		coexist_evaluate();
+	}
+}
+
+#endif
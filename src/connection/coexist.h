@@ -0,0 +1,59 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_COEXIST
+#define SLIMENRF_COEXIST
+
+#include <stdint.h>
+
+/*
+Coexistence of several receivers in one room
+Receivers announce themselves on the discovery address and coexistence channel in randomly chosen
+frames, and listen there in other randomly chosen frames. From the beacons of other receivers a
+receiver picks the least used channel and moves its frame phase away from receivers on the same
+channel. With different frame periods the tx slots keep apart only if the gcd of both periods leaves
+room for them, the phase is then chosen modulo the gcd. Trackers are moved through the sync beacon.
+
+Beacon, 12 bytes
+0 COEXIST_MAGIC, 1 version, 2-5 address id, 6 channel (255 for default), 7 stored trackers, 8-9 frame period (us), 10-11 tx slot (us, 0 if unknown)
+*/
+
+#define COEXIST_MAGIC 0xC5
+#define COEXIST_BEACON_LENGTH 12
+
+enum coexist_frame {
+	COEXIST_FRAME_NORMAL,
+	COEXIST_FRAME_LISTEN, // rx window and following tx slot listen for other receivers
+	COEXIST_FRAME_ANNOUNCE, // tx slot sends a beacon instead of sync
+};
+
+#if CONFIG_ESB_COEXIST
+enum coexist_frame coexist_frame_type(uint32_t frame);
+void coexist_write_beacon(uint16_t frame_period, uint16_t slot);
+void coexist_rx(const uint8_t *data);
+#else
+#define coexist_frame_type(frame) COEXIST_FRAME_NORMAL
+#define coexist_write_beacon(frame_period, slot) ((void)0)
+#define coexist_rx(data) ((void)0)
+#endif
+
+#endif
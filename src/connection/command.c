@@ -0,0 +1,256 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/util.h>
+#include <esb.h>
+
+#include "command.h"
+#include "timer.h"
+
+#if CONFIG_ACK_COMMANDS
+
+struct command_entry {
+	bool used;
+	uint8_t length;
+	uint8_t data[COMMAND_MAX_LENGTH]; // data[0] is imu_id
+	uint32_t queued; // uptime (ms)
+};
+
+static struct command_entry commands[CONFIG_ACK_COMMAND_QUEUE];
+static struct esb_payload tx_payload_command;
+
+static enum command_mode mode = COMMAND_MODE_ACK;
+static int preloaded = -1; // entry in the ESB TX FIFO as ACK payload
+static uint8_t preloaded_pipe;
+static int preloaded_carrier = -1; // imu_id of the packet whose ACK carried the preloaded entry
+static int slot_entry = -1; // entry in the ESB TX FIFO after the sync beacon
+static int slot_skip; // TX results before the one for slot_entry
+
+// Delivery latency, bin n counts latencies in [2^(n-1), 2^n) ms
+#define COMMAND_LATENCY_BINS 12
+
+static uint32_t latency_hist[2][COMMAND_LATENCY_BINS];
+static uint32_t delivered[2];
+static uint32_t misdelivered;
+
+LOG_MODULE_REGISTER(command, LOG_LEVEL_INF);
+
+int command_queue(uint8_t imu_id, const uint8_t *data, uint8_t length)
+{
+	if (length > COMMAND_MAX_LENGTH - 1)
+		return -EINVAL;
+	int err = -ENOMEM;
+	unsigned int key = irq_lock(); // entries are consumed from the radio ISRs
+	for (int i = 0; i < CONFIG_ACK_COMMAND_QUEUE; i++)
+	{
+		if (commands[i].used)
+			continue;
+		commands[i].data[0] = imu_id;
+		memcpy(&commands[i].data[1], data, length);
+		commands[i].length = length + 1;
+		commands[i].queued = k_uptime_get_32();
+		commands[i].used = true;
+		err = 0;
+		break;
+	}
+	irq_unlock(key);
+	return err;
+}
+
+void command_set_mode(enum command_mode new_mode)
+{
+	unsigned int key = irq_lock();
+	mode = new_mode;
+	irq_unlock(key);
+	timer_update_slot(); // announce the slot for the mode
+}
+
+bool command_slot_mode(void)
+{
+	return mode == COMMAND_MODE_SLOT;
+}
+
+// oldest queued command, for any tracker if imu_id is negative
+static int command_next(int imu_id)
+{
+	int next = -1;
+	for (int i = 0; i < CONFIG_ACK_COMMAND_QUEUE; i++)
+	{
+		if (!commands[i].used || (imu_id >= 0 && commands[i].data[0] != imu_id))
+			continue;
+		if (next < 0 || (int32_t)(commands[i].queued - commands[next].queued) < 0)
+			next = i;
+	}
+	return next;
+}
+
+static void command_delivered(int entry, enum command_mode delivery)
+{
+	uint32_t ms = k_uptime_get_32() - commands[entry].queued;
+	int bin = 0;
+	while (ms && bin < COMMAND_LATENCY_BINS - 1)
+	{
+		ms >>= 1;
+		bin++;
+	}
+	latency_hist[delivery][bin]++;
+	delivered[delivery]++;
+	commands[entry].used = false;
+}
+
+static int command_write(int entry, uint8_t pipe)
+{
+	tx_payload_command.pipe = pipe;
+	tx_payload_command.noack = false;
+	tx_payload_command.length = commands[entry].length;
+	memcpy(tx_payload_command.data, commands[entry].data, commands[entry].length);
+	return esb_write_payload(&tx_payload_command);
+}
+
+// ESB was reinitialized, the TX FIFO is empty
+void command_reset(void)
+{
+	preloaded = -1;
+	preloaded_carrier = -1;
+	slot_entry = -1;
+}
+
+// Called from the radio ISR for every accepted tracker packet while in PRX
+void command_rx(uint8_t imu_id, uint8_t pipe)
+{
+	if (preloaded >= 0)
+	{
+		// ESB keeps the ACK payload until the next packet with a new id on the pipe, the ACK for
+		// this packet (and its retransmits) carries it
+		if (pipe == preloaded_pipe && preloaded_carrier < 0)
+			preloaded_carrier = imu_id;
+		return;
+	}
+	if (mode != COMMAND_MODE_ACK)
+		return;
+	int entry = command_next(imu_id);
+	if (entry < 0)
+		return;
+	if (!command_write(entry, pipe))
+	{
+		preloaded = entry;
+		preloaded_pipe = pipe;
+	}
+}
+
+// Called after the sync beacon is written for the TX slot
+void command_write_slot(void)
+{
+	if (mode != COMMAND_MODE_SLOT || slot_entry >= 0)
+		return;
+	int entry = command_next(-1);
+	if (entry < 0)
+		return;
+	if (!command_write(entry, 0))
+	{
+		slot_entry = entry;
+		slot_skip = 1; // sync beacon
+	}
+}
+
+// Called from the ESB event handler on TX success or failure
+// In PRX TX success means the ACK payload was removed from the TX FIFO, the tracker that got it
+// acknowledged the ACK with a new packet. Another tracker on the same pipe also removes it, the
+// command then stays queued
+void command_tx_result(bool success)
+{
+	if (preloaded >= 0)
+	{
+		if (!success)
+			return;
+		if (commands[preloaded].data[0] == preloaded_carrier)
+			command_delivered(preloaded, COMMAND_MODE_ACK);
+		else
+			misdelivered++;
+		preloaded = -1;
+		preloaded_carrier = -1;
+		return;
+	}
+	if (slot_entry < 0)
+		return;
+	if (slot_skip > 0)
+	{
+		slot_skip--;
+		return;
+	}
+	if (success)
+		command_delivered(slot_entry, COMMAND_MODE_SLOT);
+	slot_entry = -1;
+}
+
+#if CONFIG_SHELL
+static int cmd_trackers_command(const struct shell *sh, size_t argc, char **argv)
+{
+	uint8_t data[COMMAND_MAX_LENGTH - 1];
+	long imu_id = strtol(argv[1], NULL, 10);
+	size_t length = hex2bin(argv[2], strlen(argv[2]), data, sizeof(data));
+	if (imu_id < 0 || imu_id >= stored_trackers || !length)
+	{
+		shell_error(sh, "Invalid tracker or command");
+		return -EINVAL;
+	}
+	int err = command_queue(imu_id, data, length);
+	if (err)
+		shell_error(sh, "Command queue full");
+	return err;
+}
+
+static int cmd_trackers_command_mode(const struct shell *sh, size_t argc, char **argv)
+{
+	if (!strcmp(argv[1], "ack"))
+		command_set_mode(COMMAND_MODE_ACK);
+	else if (!strcmp(argv[1], "slot"))
+		command_set_mode(COMMAND_MODE_SLOT);
+	else
+		return -EINVAL;
+	return 0;
+}
+
+static int cmd_trackers_command_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	static const char *const mode_names[] = {"ack", "slot"};
+	shell_print(sh, "Mode: %s, misdelivered ACK payloads: %u", mode_names[mode], misdelivered);
+	for (int m = 0; m < ARRAY_SIZE(mode_names); m++)
+	{
+		shell_print(sh, "%s: %u delivered", mode_names[m], delivered[m]);
+		for (int i = 0; i < COMMAND_LATENCY_BINS; i++)
+			if (latency_hist[m][i])
+				shell_print(sh, "  < %4u ms: %u", 1 << i, latency_hist[m][i]);
+	}
+	return 0;
+}
+
+SHELL_SUBCMD_ADD((trackers), command, NULL, "Queue a command: <imu_id> <hex>", cmd_trackers_command, 3, 0);
+SHELL_SUBCMD_ADD((trackers), command_mode, NULL, "Command delivery: ack|slot", cmd_trackers_command_mode, 2, 0);
+SHELL_SUBCMD_ADD((trackers), command_stats, NULL, "Command delivery latency", cmd_trackers_command_stats, 1, 0);
+#endif
+
+#endif
@@ -0,0 +1,64 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_COMMAND
+#define SLIMENRF_COMMAND
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+Commands to trackers, payload is imu_id followed by the command
+In ACK mode the oldest command for a tracker is preloaded as ACK payload for the pipe the tracker
+was last heard on, and is sent with the ACK of the next packet on that pipe. ESB removes it from the
+TX FIFO (ESB_EVENT_TX_SUCCESS) once a packet with a new id arrives on the pipe, which counts as
+delivered. If another tracker got the ACK it ignores the command (imu_id mismatch) and the command
+stays queued. The TX FIFO is emptied at every switch to TX, an unconfirmed command is preloaded again.
+In slot mode the oldest command is sent after the sync beacon in the TX slot. The slot is resized
+for the beacon and a command with its ACK (esb_tx_slot), commands wait until the resized slot applies.
+*/
+
+#define COMMAND_MAX_LENGTH 8 // including imu_id
+
+enum command_mode {
+	COMMAND_MODE_ACK,
+	COMMAND_MODE_SLOT,
+};
+
+#if CONFIG_ACK_COMMANDS
+int command_queue(uint8_t imu_id, const uint8_t *data, uint8_t length);
+void command_set_mode(enum command_mode mode);
+bool command_slot_mode(void);
+
+void command_reset(void);
+void command_rx(uint8_t imu_id, uint8_t pipe);
+void command_write_slot(void);
+void command_tx_result(bool success);
+#else
+#define command_slot_mode() false
+#define command_reset() ((void)0)
+#define command_rx(imu_id, pipe) ((void)0)
+#define command_write_slot() ((void)0)
+#define command_tx_result(success) ((void)0)
+#endif
+
+#endif
@@ -22,14 +22,27 @@
 */
 #include "globals.h"
 #include "system/system.h"
+#include "system/profile.h"
+#include "system/retained.h"
 #include "hid.h"
 
-#include <zephyr/drivers/clock_control/nrf_clock_control.h>
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/sys/crc.h>
+#include <zephyr/shell/shell.h>
 
 #include "esb.h"
-
-static struct esb_payload rx_payload;
+#include "esb_packet.h"
+#include "timer.h"
+#include "command.h"
+#include "coexist.h"
+#include "stats.h"
+#include "timestamp.h"
+#include "forward.h"
+#include "capture.h"
+#include "channel_scan.h"
+#include "telemetry.h"
+
+static struct rx_record rx_scratch; // used when the rx pool is exhausted, never forwarded
 //static struct esb_payload tx_payload = ESB_CREATE_PAYLOAD(0,
 //														  0, 0, 0, 0, 0, 0, 0, 0);
 static struct esb_payload tx_payload_pair = ESB_CREATE_PAYLOAD(0,
@@ -37,10 +50,14 @@ static struct esb_payload tx_payload_pair = ESB_CREATE_PAYLOAD(0,
 //static struct esb_payload tx_payload_timer = ESB_CREATE_PAYLOAD(0,
 //														  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
 static struct esb_payload tx_payload_sync = ESB_CREATE_PAYLOAD(0,
-														  0, 0, 0, 0);
+														  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+// Tracker ids stop below TELEMETRY_ID, telemetry packets must not be merged with tracker data
+#define PAIR_MAX MIN(MAX_TRACKERS, TELEMETRY_ID)
 
 uint8_t pairing_buf[8] = {0};
 static uint8_t discovered_trackers[MAX_TRACKERS] = {0};
+static struct esb_seq tracker_seq[MAX_TRACKERS] = {0};
 
 LOG_MODULE_REGISTER(esb_event, LOG_LEVEL_INF);
 
@@ -50,106 +67,149 @@ K_THREAD_DEFINE(esb_packet_filter_thread_id, 256, esb_packet_filter_thread, NULL
 static void esb_thread(void);
 K_THREAD_DEFINE(esb_thread_id, 1024, esb_thread, NULL, NULL, NULL, 6, 0, 0);
 
-static void esb_parse_pair(void);
+// Returns true if the record was passed on and must not be freed
+static RX_HOT bool esb_rx_packet(struct rx_record *record)
+{
+	struct esb_payload *payload = &record->payload;
+	bool forwarded = false;
+	uint32_t profile_cycles = profile_start();
+	stats_count(STATS_RADIO_RECEIVED);
+	switch (esb_packet_classify(payload->data, payload->length))
+	{
+	case ESB_PACKET_PAIR:
+		LOG_DBG("rx: %08X%08X", sys_get_be32(&payload->data[0]), sys_get_be32(&payload->data[4])); // no 64 bit arguments in the ISR
+		memcpy(pairing_buf, payload->data, 8);
+		switch (pairing_buf[1])
+		{
+		case 1: // receives ack generated from last packet
+			LOG_DBG("RX Pairing Sent ACK");
+			break;
+		case 2: // should "acknowledge" pairing data sent from receiver
+			LOG_DBG("RX Pairing ACK Receiver");
+			break;
+		default: // first packet in pairing burst
+			LOG_INF("RX Pairing Request");
+			break;
+		}
+		profile_end(PROFILE_ESB_PAIR, profile_cycles);
+		break;
+	case ESB_PACKET_COEXIST:
+		coexist_rx(payload->data);
+		break;
+	case ESB_PACKET_TRACKER:
+	case ESB_PACKET_RESERVED:
+		uint8_t imu_id = payload->data[1];
+		int lost;
+		if (imu_id >= stored_trackers) // not a stored tracker
+		{
+			stats_count(STATS_FILTER_DROPPED);
+			stats_tracker_drop(STATS_FILTER_DROPPED, imu_id);
+		}
+#if CONFIG_ESB_TRACKER_PIPES
+		else if (payload->pipe != esb_tracker_pipe(imu_id)) // not sent by this tracker
+		{
+			stats_count(STATS_FILTER_DROPPED);
+			stats_tracker_drop(STATS_FILTER_DROPPED, imu_id);
+		}
+#endif
+		else if (discovered_trackers[imu_id] < DETECTION_THRESHOLD) // garbage filtering of nonexistent tracker
+		{
+			discovered_trackers[imu_id]++;
+			stats_count(STATS_FILTER_DROPPED);
+			stats_tracker_drop(STATS_FILTER_DROPPED, imu_id);
+		}
+		else if (payload->data[0] >= ESB_PACKET_TYPE_RESERVED) // reserved for receiver only
+		{
+			stats_count(STATS_RESERVED_DROPPED);
+			stats_tracker_drop(STATS_RESERVED_DROPPED, imu_id);
+		}
+		else if ((lost = esb_seq_update(&tracker_seq[imu_id], payload->pid, payload->data)) < 0) // retransmit after a missed ack
+		{
+			stats_count(STATS_DUPLICATE_DROPPED);
+			stats_tracker_drop(STATS_DUPLICATE_DROPPED, imu_id);
+		}
+		else if (record == &rx_scratch) // no slot left for the hid layer
+		{
+			stats_tracker_loss(imu_id, lost);
+			stats_count(STATS_USB_DROPPED);
+		}
+		else
+		{
+			stats_tracker_loss(imu_id, lost);
+			command_rx(imu_id, payload->pipe);
+			forward_submit(record); // write to hid endpoint
+			forwarded = true;
+		}
+		profile_end(PROFILE_ESB_TRACKER, profile_cycles);
+		break;
+	default:
+		break;
+	}
+	return forwarded;
+}
 
-void event_handler(struct esb_evt const *event)
+RX_HOT void event_handler(struct esb_evt const *event)
 {
+	uint32_t profile_cycles = profile_start();
 	switch (event->evt_id)
 	{
 	case ESB_EVENT_TX_SUCCESS:
 		LOG_DBG("TX SUCCESS");
+		command_tx_result(true);
 		break;
 	case ESB_EVENT_TX_FAILED:
 		LOG_DBG("TX FAILED");
+		command_tx_result(false);
 		break;
-	case ESB_EVENT_RX_RECEIVED:
-	// TODO: make tx payload for ack here
-		int err = esb_read_rx_payload(&rx_payload);
-		if (!err) // zero, rx success
+	case ESB_EVENT_RX_RECEIVED: // ack payloads are preloaded by command_rx
+		uint32_t rx_cycles = k_cycle_get_32();
+		uint32_t timestamp = timestamp_rx();
+		stats_count(STATS_RADIO_EVENT);
+		uint32_t rx_count = 0;
+		while (1) // one event can cover several packets, drain the rx fifo
 		{
-			switch (rx_payload.length)
+			struct rx_record *record = forward_alloc();
+			if (!record)
+				record = &rx_scratch;
+			int err = esb_read_rx_payload(&record->payload); // read directly into the pool slot
+			if (err)
 			{
-			case 8:
-				LOG_DBG("rx: %16llX", *(uint64_t *)rx_payload.data);
-				memcpy(pairing_buf, rx_payload.data, 8);
-				switch (pairing_buf[1])
+				if (record != &rx_scratch)
+					forward_free(record);
+				if (!rx_count)
 				{
-				case 1: // receives ack generated from last packet
-					LOG_DBG("RX Pairing Sent ACK");
-					break;
-				case 2: // should "acknowledge" pairing data sent from receiver
-					LOG_DBG("RX Pairing ACK Receiver");
-					break;
-				default: // first packet in pairing burst
-					LOG_INF("RX Pairing Request");
-					break;
+					stats_count(STATS_RADIO_ERROR);
+					LOG_ERR("Error while reading rx packet: %d", err);
 				}
 				break;
-			case 16:
-				uint8_t imu_id = rx_payload.data[1];
-				if (imu_id >= stored_trackers) // not a stored tracker
-					return;
-				if (discovered_trackers[imu_id] < DETECTION_THRESHOLD) // garbage filtering of nonexistent tracker
-				{
-					discovered_trackers[imu_id]++;
-					return;
-				}
-				if (rx_payload.data[0] > 223) // reserved for receiver only
-					break;
-				hid_write_packet_n(rx_payload.data, rx_payload.rssi); // write to hid endpoint
-				break;
-			default:
-				break;
 			}
+			rx_count++;
+			capture_rx(&record->payload);
+			record->rx_cycles = rx_cycles;
+			record->timestamp = timestamp;
+			if (!esb_rx_packet(record) && record != &rx_scratch)
+				forward_free(record);
 		}
-		else
-		{
-			LOG_ERR("Error while reading rx packet: %d", err);
-		}
+		stats_rx_fifo(rx_count);
 		break;
 	}
+	profile_end(PROFILE_ESB_EVENT, profile_cycles);
 }
 
-int clocks_start(void)
+// Run a packet through the receive path as if it was read from the RX FIFO
+void esb_replay(const struct esb_payload *payload)
 {
-	int err;
-	int res;
-	struct onoff_manager *clk_mgr;
-	struct onoff_client clk_cli;
-	int fetch_attempts = 0;
-
-	clk_mgr = z_nrf_clock_control_get_onoff(CLOCK_CONTROL_NRF_SUBSYS_HF);
-	if (!clk_mgr)
-	{
-		LOG_ERR("Unable to get the Clock manager");
-		return -ENXIO;
-	}
-
-	sys_notify_init_spinwait(&clk_cli.notify);
-
-	err = onoff_request(clk_mgr, &clk_cli);
-	if (err < 0)
-	{
-		LOG_ERR("Clock request failed: %d", err);
-		return err;
-	}
-
-	do
-	{
-		err = sys_notify_fetch_result(&clk_cli.notify, &res);
-		if (!err && res)
-		{
-			LOG_ERR("Clock could not be started: %d", res);
-			return res;
-		}
-		if (err && ++fetch_attempts > 10000) {
-			LOG_WRN("Unable to fetch Clock request result: %d", err);
-			return err;
-		}
-	} while (err);
-
-	LOG_DBG("HF clock started");
-	return 0;
+	unsigned int key = irq_lock(); // same context as the radio ISR
+	struct rx_record *record = forward_alloc();
+	if (!record)
+		record = &rx_scratch;
+	memcpy(&record->payload, payload, sizeof(*payload));
+	record->rx_cycles = k_cycle_get_32();
+	record->timestamp = timestamp_now();
+	stats_count(STATS_RADIO_EVENT);
+	if (!esb_rx_packet(record) && record != &rx_scratch)
+		forward_free(record);
+	irq_unlock(key);
 }
 
 // this was randomly generated
@@ -159,8 +219,51 @@ static const uint8_t discovery_base_addr_1[4] = {0x28, 0xFF, 0x50, 0xB8};
 static const uint8_t discovery_addr_prefix[8] = {0xFE, 0xFF, 0x29, 0x27, 0x09, 0x02, 0xB2, 0xD6};
 
 static uint8_t base_addr_0[4], base_addr_1[4], addr_prefix[8] = {0};
+static uint8_t pipe_mask = 0xFF;
+
+#define ESB_PAIR_CHANNEL 2 // driver default
+
+static int rf_channel = -1; // driver default
+static int rf_channel_next = -1;
+static uint8_t rf_channel_countdown;
+static bool rendezvous = false; // use discovery address and coexistence channel
+
+struct radio_profile {
+	const char *name;
+	const char *modulation;
+	enum esb_bitrate bitrate;
+	bool use_fast_ramp_up;
+	uint16_t retransmit_delay; // us
+};
+
+// Same order as enum esb_radio_profile
+static const struct radio_profile radio_profiles[ESB_PROFILE_COUNT] = {
+	{"default", "2Mbit", ESB_BITRATE_2MBPS, false, 600},
+	{"low_latency", "2Mbit", ESB_BITRATE_2MBPS, true, 250},
+	{"long_range", "1Mbit", ESB_BITRATE_1MBPS, false, 600},
+#ifdef RADIO_MODE_MODE_Ble_2Mbit
+	{"ble_2m", "BLE 2Mbit", ESB_BITRATE_2MBPS_BLE, false, 600},
+#else
+	{"ble_2m", "2Mbit", ESB_BITRATE_2MBPS, false, 600}, // not supported by the radio
+#endif
+};
+
+#define ESB_PROFILE_MIGRATE_FRAMES 100
+
+#ifdef CONFIG_ESB_RADIO_PROFILE
+#define ESB_PROFILE_UNSTORED CONFIG_ESB_RADIO_PROFILE // until a profile is stored
+#else
+#define ESB_PROFILE_UNSTORED ESB_PROFILE_DEFAULT // built without the application Kconfig (tests)
+#endif
+
+static int rf_profile = ESB_PROFILE_DEFAULT;
+static int rf_profile_next = -1;
+static uint8_t rf_profile_countdown;
 
 static bool esb_initialized = false;
+static bool esb_pairing = false;
+static bool esb_paired = false;
+static int64_t pair_last_added; // uptime (ms)
 
 int esb_initialize(bool tx)
 {
@@ -169,49 +272,64 @@ int esb_initialize(bool tx)
 	int err;
 
 	struct esb_config config = ESB_DEFAULT_CONFIG;
+	// trackers that are not paired yet only know the default profile
+	const struct radio_profile *profile = &radio_profiles[(rendezvous || esb_pairing) ? ESB_PROFILE_DEFAULT : rf_profile];
 
 	if (tx)
 	{
 		// config.protocol = ESB_PROTOCOL_ESB_DPL;
 		// config.mode = ESB_MODE_PTX;
 		config.event_handler = event_handler;
-		// config.bitrate = ESB_BITRATE_2MBPS;
-		// config.crc = ESB_CRC_16BIT;
+		config.bitrate = profile->bitrate;
+		config.crc = ESB_CRC_16BIT;
 		config.tx_output_power = 30;
-		// config.retransmit_delay = 600;
+		config.retransmit_delay = profile->retransmit_delay;
 		config.retransmit_count = 0;
 		config.tx_mode = ESB_TXMODE_MANUAL;
 		// config.payload_length = 32;
 		config.selective_auto_ack = true;
-//		config.use_fast_ramp_up = true;
+		config.use_fast_ramp_up = profile->use_fast_ramp_up;
 	}
 	else
 	{
 		// config.protocol = ESB_PROTOCOL_ESB_DPL;
 		config.mode = ESB_MODE_PRX;
 		config.event_handler = event_handler;
-		// config.bitrate = ESB_BITRATE_2MBPS;
-		// config.crc = ESB_CRC_16BIT;
+		config.bitrate = profile->bitrate;
+		config.crc = ESB_CRC_16BIT;
 		config.tx_output_power = 30;
-		// config.retransmit_delay = 600;
+		config.retransmit_delay = profile->retransmit_delay;
 		// config.retransmit_count = 3;
 		// config.tx_mode = ESB_TXMODE_AUTO;
 		// config.payload_length = 32;
 		config.selective_auto_ack = true;
-//		config.use_fast_ramp_up = true;
+		config.use_fast_ramp_up = profile->use_fast_ramp_up;
 	}
 
-	LOG_INF("Initializing ESB, %sX mode", tx ? "T" : "R");
+	LOG_INF("Initializing ESB, %sX mode, %s", tx ? "T" : "R", profile->name);
 	err = esb_init(&config);
 
 	if (!err)
-		esb_set_base_address_0(base_addr_0);
+		esb_set_base_address_0(rendezvous ? discovery_base_addr_0 : base_addr_0);
 
 	if (!err)
-		esb_set_base_address_1(base_addr_1);
+		esb_set_base_address_1(rendezvous ? discovery_base_addr_1 : base_addr_1);
 
 	if (!err)
-		esb_set_prefixes(addr_prefix, ARRAY_SIZE(addr_prefix));
+		esb_set_prefixes(rendezvous ? discovery_addr_prefix : addr_prefix, ARRAY_SIZE(addr_prefix));
+
+	if (!err)
+		esb_enable_pipes(rendezvous ? 0xFF : pipe_mask);
+
+	int channel = rf_channel;
+	if (esb_pairing) // trackers that are not paired yet only know the default channel
+		channel = ESB_PAIR_CHANNEL;
+#if CONFIG_ESB_COEXIST
+	if (rendezvous)
+		channel = CONFIG_ESB_COEXIST_CHANNEL;
+#endif
+	if (!err && channel >= 0)
+		esb_set_rf_channel(channel);
 
 	if (err)
 	{
@@ -220,6 +338,7 @@ int esb_initialize(bool tx)
 		return err;
 	}
 
+	command_reset(); // tx fifo is empty after init
 	esb_initialized = true;
 	return 0;
 }
@@ -247,35 +366,89 @@ inline void esb_set_addr_discovery(void)
 	memcpy(base_addr_0, discovery_base_addr_0, sizeof(base_addr_0));
 	memcpy(base_addr_1, discovery_base_addr_1, sizeof(base_addr_1));
 	memcpy(addr_prefix, discovery_addr_prefix, sizeof(addr_prefix));
+	pipe_mask = 0xFF;
 }
 
 inline void esb_set_addr_paired(void)
 {
-	// Generate addresses from device address
-	uint64_t *addr = (uint64_t *)NRF_FICR->DEVICEADDR; // Use device address as unique identifier (although it is not actually guaranteed, see datasheet)
-	uint8_t buf[6] = {0};
-	memcpy(buf, addr, 6);
-	uint8_t addr_buffer[16] = {0};
-	for (int i = 0; i < 4; i++)
-	{
-		addr_buffer[i] = buf[i];
-		addr_buffer[i + 4] = buf[i] + buf[4];
-	}
-	for (int i = 0; i < 8; i++)
-		addr_buffer[i + 8] = buf[5] + i;
-	for (int i = 0; i < 16; i++)
+	esb_addr_from_device(sys_device_addr(), base_addr_0, base_addr_1, addr_prefix);
+#if CONFIG_ESB_TRACKER_PIPES
+	pipe_mask = esb_tracker_pipe_mask(stored_trackers); // only listen on pipes used by stored trackers
+#else
+	pipe_mask = 0xFF;
+#endif
+}
+
+// Identifies the paired address set, used to detect receivers with colliding addresses
+uint32_t esb_addr_id(void)
+{
+	uint8_t base_0[4], base_1[4], prefix[8];
+	esb_addr_from_device(sys_device_addr(), base_0, base_1, prefix);
+	if (!memcmp(base_0, discovery_base_addr_0, sizeof(base_0)) || !memcmp(base_1, discovery_base_addr_1, sizeof(base_1)))
+		LOG_WRN("Paired address collides with discovery address");
+	uint32_t id = crc32_ieee(base_0, sizeof(base_0));
+	id = crc32_ieee_update(id, base_1, sizeof(base_1));
+	return crc32_ieee_update(id, prefix, sizeof(prefix));
+}
+
+// Takes effect on the next initialization
+void esb_set_rendezvous(bool enable)
+{
+	rendezvous = enable;
+}
+
+int esb_get_channel(void)
+{
+	return rf_channel;
+}
+
+void esb_set_channel(int channel)
+{
+	rf_channel = channel;
+}
+
+// Announce the channel to trackers in the sync beacon, then switch after the countdown
+void esb_migrate_channel(int channel, uint8_t frames)
+{
+	unsigned int key = irq_lock(); // read by esb_write_sync in the radio timer ISR
+	rf_channel_countdown = frames;
+	rf_channel_next = channel;
+	irq_unlock(key);
+}
+
+int esb_get_radio_profile(void)
+{
+	return rf_profile;
+}
+
+int esb_find_radio_profile(const char *name)
+{
+	for (int i = 0; i < ESB_PROFILE_COUNT; i++)
+		if (!strcmp(radio_profiles[i].name, name))
+			return i;
+	return -EINVAL;
+}
+
+// Stored right away, trackers follow through the sync beacon before the receiver switches
+void esb_set_radio_profile(int profile)
+{
+	if (profile < 0 || profile >= ESB_PROFILE_COUNT)
+		return;
+	uint8_t stored = profile + 1;
+	sys_write(STORED_RADIO_PROFILE, &retained->radio_profile, &stored, sizeof(stored));
+	LOG_INF("Radio profile %s", radio_profiles[profile].name);
+	if (!esb_initialized || !esb_paired) // nothing to announce to
 	{
-		if (addr_buffer[i] == 0x00 || addr_buffer[i] == 0x55 || addr_buffer[i] == 0xAA) // Avoid invalid addresses (see nrf datasheet)
-			addr_buffer[i] += 8;
+		rf_profile = profile;
+		rf_profile_next = -1;
+		timer_update_slot();
+		return;
 	}
-	memcpy(base_addr_0, addr_buffer, sizeof(base_addr_0));
-	memcpy(base_addr_1, addr_buffer + 4, sizeof(base_addr_1));
-	memcpy(addr_prefix, addr_buffer + 8, sizeof(addr_prefix));
+	rf_profile_countdown = ESB_PROFILE_MIGRATE_FRAMES;
+	rf_profile_next = profile;
+	timer_update_slot(); // announced in fewer frames than the profile, fits both until the switch
 }
 
-static bool esb_pairing = false;
-static bool esb_paired = false;
-
 void esb_add_pair(uint64_t addr, bool checksum)
 {
 	int id = stored_trackers;
@@ -289,13 +462,18 @@ void esb_add_pair(uint64_t addr, bool checksum)
 			}
 		}
 	}
+	if (id == stored_trackers && stored_trackers >= PAIR_MAX)
+	{
+		LOG_WRN("No space for device with address %012llX", addr);
+		return;
+	}
 	if (id == stored_trackers)
 	{
 		LOG_INF("Added device on id %d with address %012llX", id, addr);
 		stored_tracker_addr[id] = addr;
-		sys_write(STORED_ADDR_0 + id, NULL, &stored_tracker_addr[id], sizeof(stored_tracker_addr[0]));
+		sys_write(STORED_ADDR_0 + id, &retained->stored_tracker_addr[id], &stored_tracker_addr[id], sizeof(stored_tracker_addr[0]));
 		stored_trackers++;
-		sys_write(STORED_TRACKERS, NULL, &stored_trackers, sizeof(stored_trackers));
+		sys_write(STORED_TRACKERS, &retained->stored_trackers, &stored_trackers, sizeof(stored_trackers));
 	}
 	else
 	{
@@ -305,13 +483,7 @@ void esb_add_pair(uint64_t addr, bool checksum)
 	{
 		uint8_t buf[6] = {0};
 		memcpy(buf, &addr, 6);
-		uint8_t checksum = crc8_ccitt(0x07, buf, 6);
-		if (checksum == 0)
-			checksum = 8;
-		uint64_t *receiver_addr = (uint64_t *)NRF_FICR->DEVICEADDR; // Use device address as unique identifier (although it is not actually guaranteed, see datasheet
-		addr = (*receiver_addr & 0xFFFFFFFFFFFF) << 16;
-		addr |= checksum; // Add checksum to the address
-		addr |= (uint64_t)id << 8; // Add tracker id to the address
+		addr = esb_pair_response_addr(sys_device_addr(), id, esb_pair_checksum(buf));
 		LOG_INF("Pair the device with %016llX", addr);
 	}
 }
@@ -321,7 +493,7 @@ void esb_pop_pair(void)
 	if (stored_trackers > 0)
 	{
 		stored_trackers--;
-		sys_write(STORED_TRACKERS, NULL, &stored_trackers, sizeof(stored_trackers));
+		sys_write(STORED_TRACKERS, &retained->stored_trackers, &stored_trackers, sizeof(stored_trackers));
 		LOG_INF("Removed device on id %d with address %012llX", stored_trackers, stored_tracker_addr[stored_trackers]);
 	}
 	else
@@ -332,7 +504,7 @@ void esb_pop_pair(void)
 
 void esb_parse_pair()
 {
-	uint64_t found_addr = (*(uint64_t *)pairing_buf >> 16) & 0xFFFFFFFFFFFF;
+	uint64_t found_addr = esb_pair_addr(pairing_buf);
 	uint16_t send_tracker_id = stored_trackers; // Use new tracker id
 	for (int i = 0; i < stored_trackers; i++) // Check if the device is already stored
 	{
@@ -342,15 +514,14 @@ void esb_parse_pair()
 			send_tracker_id = i;
 		}
 	}
-	uint8_t checksum = crc8_ccitt(0x07, &pairing_buf[2], 6); // make sure the packet is valid
-	if (checksum == 0)
-		checksum = 8;
-	if (checksum == pairing_buf[0] && found_addr != 0 && send_tracker_id == stored_trackers && stored_trackers < MAX_TRACKERS) // New device, add to NVS
+	bool valid = esb_pair_valid(pairing_buf); // make sure the packet is valid
+	if (valid && found_addr != 0 && send_tracker_id == stored_trackers && stored_trackers < PAIR_MAX) // New device, add to NVS
 	{
 		esb_add_pair(found_addr, false);
+		pair_last_added = k_uptime_get();
 		set_led(SYS_LED_PATTERN_ONESHOT_PROGRESS, SYS_LED_PRIORITY_HIGHEST);
 	}
-	if (checksum == pairing_buf[0] && send_tracker_id < MAX_TRACKERS) // Make sure the dongle is not full
+	if (valid && send_tracker_id < PAIR_MAX) // Make sure the dongle is not full
 		tx_payload_pair.data[0] = pairing_buf[0]; // Use checksum sent from device to make sure packet is for that device
 	else
 		tx_payload_pair.data[0] = 0; // Invalidate packet
@@ -361,17 +532,26 @@ void esb_pair(void)
 {
 	LOG_INF("Pairing");
 	esb_set_addr_discovery();
+	pairing_buf[1] = 255; // initialize packet flag
+	esb_pairing = true; // before initialization, pairing uses the default profile and channel
+	pair_last_added = k_uptime_get();
 	esb_initialize(false);
 	esb_start_rx();
 	tx_payload_pair.noack = false;
-	uint64_t *addr = (uint64_t *)NRF_FICR->DEVICEADDR; // Use device address as unique identifier (although it is not actually guaranteed, see datasheet)
-	memcpy(&tx_payload_pair.data[2], addr, 6);
-	LOG_INF("Device address: %012llX", *addr & 0xFFFFFFFFFFFF);
+	uint64_t addr = sys_device_addr();
+	memcpy(&tx_payload_pair.data[2], &addr, 6);
+	LOG_INF("Device address: %012llX", addr);
 	set_led(SYS_LED_PATTERN_SHORT, SYS_LED_PRIORITY_CONNECTION);
-	esb_pairing = true;
-	pairing_buf[1] = 255; // initialize packet flag
 	while (esb_pairing)
 	{
+#if CONFIG_ESB_PAIR_TIMEOUT
+		if (stored_trackers && k_uptime_get() - pair_last_added > CONFIG_ESB_PAIR_TIMEOUT * 1000)
+		{
+			LOG_INF("No new tracker for %ds, finishing pairing", CONFIG_ESB_PAIR_TIMEOUT);
+			esb_pairing = false;
+			break;
+		}
+#endif
 		if (!esb_initialized)
 		{
 			esb_initialize(false);
@@ -385,7 +565,7 @@ void esb_pair(void)
 			break;
 		default: // first packet in pairing burst
 			esb_parse_pair();
-			LOG_DBG("tx: %16llX", *(uint64_t *)tx_payload_pair.data);
+			LOG_DBG("tx: %08X%08X", sys_get_be32(&tx_payload_pair.data[0]), sys_get_be32(&tx_payload_pair.data[4]));
 			esb_write_payload(&tx_payload_pair); // Add to TX buffer
 			break;
 		}
@@ -413,20 +593,85 @@ void esb_finish_pair(void)
 void esb_clear(void)
 {
 	stored_trackers = 0;
-	sys_write(STORED_TRACKERS, NULL, &stored_trackers, sizeof(stored_trackers));
+	sys_write(STORED_TRACKERS, &retained->stored_trackers, &stored_trackers, sizeof(stored_trackers));
 	LOG_INF("NVS Reset");
 	esb_reset_pair();
 }
 
-// TODO:
-void esb_write_sync(uint16_t led_clock)
+#define ESB_TX_SLOT_MARGIN 20 // us, timer ISR latency before the transmission starts
+#define ESB_TX_SLOT_MAX (255 * 4) // us, largest slot the sync beacon can announce
+
+// Sync beacon and, in command slot mode, a command waiting for its ACK (us)
+static uint32_t esb_slot_time(enum esb_radio_profile profile, bool command)
+{
+	uint32_t time = esb_transaction_time(profile, ESB_SYNC_LENGTH, false);
+	if (command)
+		time += esb_transaction_time(profile, COMMAND_MAX_LENGTH, true);
+	return time;
+}
+
+// Slot after the frame start for the sync beacon (us)
+uint32_t esb_tx_slot(void)
+{
+	bool command = command_slot_mode();
+	uint32_t slot = esb_slot_time(rf_profile, command);
+	if (rf_profile_next >= 0) // the slot grows before the switch
+		slot = MAX(slot, esb_slot_time(rf_profile_next, command));
+#if CONFIG_ESB_COEXIST
+	slot = MAX(slot, esb_transaction_time(ESB_PROFILE_DEFAULT, COEXIST_BEACON_LENGTH, false)); // sent instead of the beacon
+#endif
+	return MIN(slot + ESB_TX_SLOT_MARGIN, ESB_TX_SLOT_MAX);
+}
+
+// Called before the TX slot, frame and time describe the frame starting with the transmission
+void esb_write_sync(uint16_t led_clock, uint32_t frame, uint32_t frame_time, uint16_t frame_period,
+		uint16_t next_period, uint8_t countdown, uint16_t tx_slot)
 {
 	if (!esb_initialized || !esb_paired)
 		return;
-	tx_payload_sync.noack = false;
-	tx_payload_sync.data[0] = (led_clock >> 8) & 255;
-	tx_payload_sync.data[1] = led_clock & 255;
+	// the current slot, not the announced one, must fit the command with the profile sending the beacon
+	bool command_fits = esb_slot_time(rf_profile, true) + ESB_TX_SLOT_MARGIN <= timer_frame_slot();
+	tx_payload_sync.noack = true; // for all trackers, their ACKs would collide
+	sys_put_be16(led_clock, &tx_payload_sync.data[0]);
+	sys_put_be32(frame, &tx_payload_sync.data[2]);
+	sys_put_be32(frame_time, &tx_payload_sync.data[6]);
+	sys_put_be16(frame_period, &tx_payload_sync.data[10]);
+	if (rf_channel_next >= 0)
+	{
+		tx_payload_sync.data[12] = rf_channel_next;
+		tx_payload_sync.data[13] = rf_channel_countdown;
+		if (!rf_channel_countdown--) // switch with the next initialization
+		{
+			rf_channel = rf_channel_next;
+			rf_channel_next = -1;
+		}
+	}
+	else
+	{
+		tx_payload_sync.data[12] = rf_channel < 0 ? 0xFF : rf_channel;
+		tx_payload_sync.data[13] = 0;
+	}
+	if (rf_profile_next >= 0)
+	{
+		tx_payload_sync.data[14] = rf_profile_next;
+		tx_payload_sync.data[15] = rf_profile_countdown;
+		if (!rf_profile_countdown--) // switch with the next initialization
+		{
+			rf_profile = rf_profile_next;
+			rf_profile_next = -1;
+		}
+	}
+	else
+	{
+		tx_payload_sync.data[14] = rf_profile;
+		tx_payload_sync.data[15] = 0;
+	}
+	sys_put_be16(next_period, &tx_payload_sync.data[16]);
+	tx_payload_sync.data[18] = countdown;
+	tx_payload_sync.data[19] = MIN(tx_slot / 4, 255);
 	esb_write_payload(&tx_payload_sync);
+	if (command_fits) // otherwise it stays queued until the resized slot applies
+		command_write_slot();
 }
 
 // TODO:
@@ -450,20 +695,49 @@ static void esb_packet_filter_thread(void)
 
 static void esb_thread(void)
 {
-	clocks_start();
+	// HF clock startup, NVS mount and USB enumeration overlap, only RX needs the clock
+	clocks_request();
 
-	sys_read(STORED_TRACKERS, &stored_trackers, sizeof(stored_trackers));
+	if (retained_valid()) // warm boot, start receiving without reading NVS
+	{
+		stored_trackers = retained->stored_trackers;
+		memcpy(stored_tracker_addr, retained->stored_tracker_addr, sizeof(stored_tracker_addr[0]) * stored_trackers);
+		rf_profile = retained->radio_profile ? retained->radio_profile - 1 : ESB_PROFILE_UNSTORED;
+		rf_channel = retained->rf_channel - 1;
+	}
+	else
+	{
+		uint8_t stored_profile;
+		uint8_t stored_channel;
+		sys_read(STORED_TRACKERS, &stored_trackers, sizeof(stored_trackers));
+		stored_trackers = MIN(stored_trackers, PAIR_MAX); // stored before the limit
+		for (int i = 0; i < stored_trackers; i++)
+			sys_read(STORED_ADDR_0 + i, &stored_tracker_addr[i], sizeof(stored_tracker_addr[0]));
+		sys_read(STORED_RADIO_PROFILE, &stored_profile, sizeof(stored_profile)); // 0 if never stored
+		rf_profile = stored_profile && stored_profile <= ESB_PROFILE_COUNT ? stored_profile - 1 : ESB_PROFILE_UNSTORED;
+		sys_read(STORED_RF_CHANNEL, &stored_channel, sizeof(stored_channel));
+		rf_channel = stored_channel - 1;
+		retained->stored_trackers = stored_trackers;
+		memcpy(retained->stored_tracker_addr, stored_tracker_addr, sizeof(stored_tracker_addr[0]) * stored_trackers);
+		retained->radio_profile = stored_profile;
+		retained->rf_channel = stored_channel;
+		retained_loaded(RETAINED_TRACKERS);
+	}
 	if (stored_trackers)
 		esb_paired = true;
-	for (int i = 0; i < stored_trackers; i++)
-		sys_read(STORED_ADDR_0 + i, &stored_tracker_addr[i], sizeof(stored_tracker_addr[0]));
-	LOG_INF("%d/%d devices stored", stored_trackers, MAX_TRACKERS);
+	sys_boot_phase(SYS_BOOT_TRACKERS);
+	LOG_INF("%d/%d devices stored (%s boot)", stored_trackers, PAIR_MAX, retained_valid() ? "warm" : "cold");
+
+	clocks_wait();
+	channel_scan_boot(); // the radio is still free
 
 	if (esb_paired)
 	{
 		esb_receive();
 		esb_initialize(false);
 		esb_start_rx();
+		timer_init(); // frames with the sync beacon and tx slot
+		sys_boot_phase(SYS_BOOT_RX);
 	}
 
 	while (1)
@@ -474,7 +748,57 @@ static void esb_thread(void)
 			esb_receive();
 			esb_initialize(false);
 			esb_start_rx();
+			timer_init();
+			sys_boot_phase(SYS_BOOT_RX);
 		}
 		k_msleep(100);
 	}
 }
+
+#if CONFIG_SHELL
+static int cmd_trackers_list(const struct shell *sh, size_t argc, char **argv)
+{
+	shell_print(sh, "%d/%d devices stored", stored_trackers, PAIR_MAX);
+	for (int i = 0; i < stored_trackers; i++)
+		shell_print(sh, "%3d %012llX", i, stored_tracker_addr[i]);
+	return 0;
+}
+
+static int cmd_trackers_radio(const struct shell *sh, size_t argc, char **argv)
+{
+	if (argc == 2)
+	{
+		int profile = esb_find_radio_profile(argv[1]);
+		if (profile < 0)
+		{
+			shell_error(sh, "Unknown radio profile %s", argv[1]);
+			return -EINVAL;
+		}
+		esb_set_radio_profile(profile);
+	}
+	for (int i = 0; i < ESB_PROFILE_COUNT; i++)
+	{
+		const struct radio_profile *profile = &radio_profiles[i];
+		shell_print(sh, "%c %-12s %s%s, retransmit delay %uus", i == rf_profile ? '*' : (i == rf_profile_next ? '>' : ' '), profile->name,
+				profile->modulation, profile->use_fast_ramp_up ? ", fast ramp-up" : "", profile->retransmit_delay);
+	}
+	return 0;
+}
+
+static int cmd_trackers_finish_pair(const struct shell *sh, size_t argc, char **argv)
+{
+	if (!esb_pairing)
+	{
+		shell_error(sh, "Not pairing");
+		return -EINVAL;
+	}
+	esb_finish_pair();
+	return 0;
+}
+
+SHELL_SUBCMD_SET_CREATE(trackers_cmds, (trackers));
+SHELL_SUBCMD_ADD((trackers), list, NULL, "List stored trackers", cmd_trackers_list, 1, 0);
+SHELL_SUBCMD_ADD((trackers), finish_pair, NULL, "Finish pairing and start receiving", cmd_trackers_finish_pair, 1, 0);
+SHELL_SUBCMD_ADD((trackers), radio, NULL, "Show or select the radio profile: [name]", cmd_trackers_radio, 1, 1);
+SHELL_CMD_REGISTER(trackers, &trackers_cmds, "Tracker commands", NULL);
+#endif
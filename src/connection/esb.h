@@ -26,20 +26,53 @@
 #include <esb.h>
 
 void event_handler(struct esb_evt const* event);
-int clocks_start(void);
+void esb_replay(const struct esb_payload *payload);
 int esb_initialize(bool);
 
 void esb_set_addr_discovery(void);
+// Paired trackers use the addresses derived from the receiver device address
+// With CONFIG_ESB_TRACKER_PIPES tracker n must transmit on pipe n % 8
 void esb_set_addr_paired(void);
 
+uint32_t esb_addr_id(void);
+void esb_set_rendezvous(bool enable);
+int esb_get_channel(void);
+void esb_set_channel(int channel); // before initialization, trackers are not told
+void esb_migrate_channel(int channel, uint8_t frames);
+int esb_get_radio_profile(void);
+int esb_find_radio_profile(const char *name);
+void esb_set_radio_profile(int profile);
+
 void esb_add_pair(uint64_t addr, bool checksum);
+void esb_parse_pair(void); // answer the pairing request last received, called by the pairing thread
 void esb_pop_pair(void);
 
 void esb_pair(void);
 void esb_reset_pair(void);
 void esb_finish_pair(void);
 void esb_clear(void);
-void esb_write_sync(uint16_t led_clock);
+/*
+Sync payload, sent at the start of every frame, all values big endian
+0-1 led_clock, 2-5 frame number, 6-9 receiver time at the start of the frame (us), 10-11 frame period (us),
+12 channel (255 for the default channel), 13 frames until the receiver switches to this channel
+14 radio profile (enum esb_radio_profile), 15 frames until the receiver switches to this profile
+16-17 announced frame period (us), 18 frames until it applies, 19 tx slot before and after the frame start (4 us)
+While no change is pending 16-17 and 19 describe the current frame and 18 is 0. The period in 10-11 is the
+one of the frame this beacon starts, it changes at the frame after the beacon with a countdown of 0.
+
+The transmission is started by the frame timer, so the time in the payload is when the
+transmission started, the delay until the tracker sees the address match is constant
+(radio ramp-up, preamble and address). Trackers estimate their clock offset and drift
+against the receiver time from consecutive beacons and place their sample instants at
+a fixed phase in the receiver frame, see scripts/sync_sim.py.
+
+The beacon is sent without ACK. The tx slot after the frame start fits it (esb_tx_slot) with the
+ramp-up and bitrate of the active profile and of a profile being announced. In command slot mode
+it also fits a command after the beacon and its ACK.
+*/
+uint32_t esb_tx_slot(void);
+void esb_write_sync(uint16_t led_clock, uint32_t frame, uint32_t frame_time, uint16_t frame_period,
+		uint16_t next_period, uint8_t countdown, uint16_t tx_slot);
 void esb_receive(void);
 
 #endif
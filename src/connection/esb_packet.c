@@ -0,0 +1,155 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include <string.h>
+#include <zephyr/sys/crc.h>
+
+#include "esb_packet.h"
+
+#define ESB_RAMP_UP 140 // us, nRF52 radio TX and RX ramp-up
+#define ESB_RAMP_UP_FAST 40 // us, ESB_PROFILE_LOW_LATENCY
+#define ESB_TURNAROUND 6 // us, from the end of a packet until the radio can ramp up again
+
+enum esb_packet_type esb_packet_classify(const uint8_t *data, uint8_t length)
+{
+	switch (length)
+	{
+	case 8:
+		return ESB_PACKET_PAIR;
+	case 12:
+		return ESB_PACKET_COEXIST;
+	case 16:
+		if (data[0] >= ESB_PACKET_TYPE_RESERVED)
+			return ESB_PACKET_RESERVED;
+		return ESB_PACKET_TRACKER;
+	default:
+		return ESB_PACKET_INVALID;
+	}
+}
+
+// checksum of a 6 byte device address, zero is not a valid checksum
+uint8_t esb_pair_checksum(const uint8_t *addr)
+{
+	uint8_t checksum = crc8_ccitt(0x07, addr, 6);
+	if (checksum == 0)
+		checksum = 8;
+	return checksum;
+}
+
+// device address sent in a pairing request
+uint64_t esb_pair_addr(const uint8_t *pairing_buf)
+{
+	uint64_t buf;
+	memcpy(&buf, pairing_buf, sizeof(buf));
+	return (buf >> 16) & 0xFFFFFFFFFFFF;
+}
+
+// make sure the packet is valid
+bool esb_pair_valid(const uint8_t *pairing_buf)
+{
+	return esb_pair_checksum(&pairing_buf[2]) == pairing_buf[0];
+}
+
+uint64_t esb_pair_response_addr(uint64_t receiver_addr, uint8_t id, uint8_t checksum)
+{
+	uint64_t addr = (receiver_addr & 0xFFFFFFFFFFFF) << 16;
+	addr |= checksum; // Add checksum to the address
+	addr |= (uint64_t)id << 8; // Add tracker id to the address
+	return addr;
+}
+
+// Pipe a paired tracker transmits on, trackers are spread over all pipes by id
+uint8_t esb_tracker_pipe(uint8_t imu_id)
+{
+	return imu_id % ESB_PIPE_COUNT;
+}
+
+// Pipes used by the first n trackers
+uint8_t esb_tracker_pipe_mask(int trackers)
+{
+	if (trackers >= ESB_PIPE_COUNT)
+		return (1 << ESB_PIPE_COUNT) - 1;
+	return (1 << trackers) - 1;
+}
+
+// Generate addresses from device address
+void esb_addr_from_device(uint64_t device_addr, uint8_t base_addr_0[4], uint8_t base_addr_1[4], uint8_t addr_prefix[8])
+{
+	uint8_t buf[6] = {0};
+	memcpy(buf, &device_addr, 6);
+	uint8_t addr_buffer[16] = {0};
+	for (int i = 0; i < 4; i++)
+	{
+		addr_buffer[i] = buf[i];
+		addr_buffer[i + 4] = buf[i] + buf[4];
+	}
+	for (int i = 0; i < 8; i++)
+		addr_buffer[i + 8] = buf[5] + i;
+	for (int i = 0; i < 16; i++)
+	{
+		if (addr_buffer[i] == 0x00 || addr_buffer[i] == 0x55 || addr_buffer[i] == 0xAA) // Avoid invalid addresses (see nrf datasheet)
+			addr_buffer[i] += 8;
+	}
+	memcpy(base_addr_0, addr_buffer, 4);
+	memcpy(base_addr_1, addr_buffer + 4, 4);
+	memcpy(addr_prefix, addr_buffer + 8, 8);
+}
+
+// Time on air of a packet (us): preamble, 5 byte address, 9 bit control field, payload and 16 bit CRC
+uint32_t esb_airtime(enum esb_radio_profile profile, uint8_t length)
+{
+	bool one_mbit = profile == ESB_PROFILE_LONG_RANGE;
+	uint32_t bits = (one_mbit ? 8 : 16) + 40 + 9 + length * 8 + 16;
+	return one_mbit ? bits : (bits + 1) / 2;
+}
+
+// From the start of TX ramp-up until the packet is sent, or until the ACK is received
+// The receiving side sends ACKs without payload
+uint32_t esb_transaction_time(enum esb_radio_profile profile, uint8_t length, bool ack)
+{
+	uint32_t ramp_up = profile == ESB_PROFILE_LOW_LATENCY ? ESB_RAMP_UP_FAST : ESB_RAMP_UP;
+	uint32_t time = ramp_up + esb_airtime(profile, length);
+	if (ack)
+		time += ESB_TURNAROUND + ramp_up + esb_airtime(profile, 0);
+	return time;
+}
+
+// Returns -1 for a retransmit of the last packet, otherwise the number of packets lost before this one
+// The transmitter increments the 2 bit packet id for each new packet, but not for retransmits after a
+// missed ack. A run of 4 or more lost packets aliases to a shorter one
+int esb_seq_update(struct esb_seq *seq, uint8_t pid, const uint8_t *data)
+{
+	uint16_t crc = crc16_ccitt(0xFFFF, data, 16);
+	if (!seq->valid)
+	{
+		seq->valid = true;
+		seq->pid = pid;
+		seq->crc = crc;
+		return 0;
+	}
+	uint8_t delta = (pid - seq->pid) & 3;
+	if (delta == 0 && crc == seq->crc)
+		return -1;
+	seq->pid = pid;
+	seq->crc = crc;
+	return delta ? delta - 1 : 3; // same id with other data, the id wrapped around
+}
@@ -0,0 +1,78 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_ESB_PACKET
+#define SLIMENRF_ESB_PACKET
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Protocol logic only, no radio or NVS access, so this can be built for any target
+
+enum esb_packet_type {
+	ESB_PACKET_INVALID,
+	ESB_PACKET_PAIR, // 8 byte pairing packet
+	ESB_PACKET_COEXIST, // 12 byte beacon from another receiver
+	ESB_PACKET_TRACKER, // 16 byte tracker data packet
+	ESB_PACKET_RESERVED, // tracker data packet using a type reserved for the receiver
+};
+
+#define ESB_PACKET_TYPE_RESERVED 224 // packet types from here on are reserved for receiver only
+
+#define ESB_PIPE_COUNT 8
+
+#define ESB_SYNC_LENGTH 20 // sync beacon payload, see esb.h
+
+// Radio profiles, announced in the sync beacon, pairing always uses ESB_PROFILE_DEFAULT
+enum esb_radio_profile {
+	ESB_PROFILE_DEFAULT, // 2Mbit
+	ESB_PROFILE_LOW_LATENCY, // 2Mbit, fast ramp-up, shortest retransmit delay
+	ESB_PROFILE_LONG_RANGE, // 1Mbit, more link budget
+	ESB_PROFILE_BLE_2M, // BLE 2Mbit modulation
+	ESB_PROFILE_COUNT
+};
+
+enum esb_packet_type esb_packet_classify(const uint8_t *data, uint8_t length);
+
+uint32_t esb_airtime(enum esb_radio_profile profile, uint8_t length);
+uint32_t esb_transaction_time(enum esb_radio_profile profile, uint8_t length, bool ack);
+
+uint8_t esb_pair_checksum(const uint8_t *addr);
+uint64_t esb_pair_addr(const uint8_t *pairing_buf);
+bool esb_pair_valid(const uint8_t *pairing_buf);
+uint64_t esb_pair_response_addr(uint64_t receiver_addr, uint8_t id, uint8_t checksum);
+
+uint8_t esb_tracker_pipe(uint8_t imu_id);
+uint8_t esb_tracker_pipe_mask(int trackers);
+
+// Per tracker history of the ESB packet id, to find retransmits and lost packets
+struct esb_seq {
+	uint16_t crc; // of the last packet
+	uint8_t pid; // of the last packet
+	bool valid;
+};
+
+int esb_seq_update(struct esb_seq *seq, uint8_t pid, const uint8_t *data);
+
+void esb_addr_from_device(uint64_t device_addr, uint8_t base_addr_0[4], uint8_t base_addr_1[4], uint8_t addr_prefix[8]);
+
+#endif
@@ -0,0 +1,227 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+#include "system/system.h"
+#include "system/retained.h"
+#include "system/profile.h"
+#include "forward.h"
+#include "hid_tx.h"
+#include "predict.h"
+#include "stats.h"
+#include "timestamp.h"
+
+K_MEM_SLAB_DEFINE_STATIC(rx_pool, sizeof(struct rx_record), CONFIG_RX_POOL_SIZE, 4);
+static K_FIFO_DEFINE(forward_fifo);
+
+// Records held back while the hid layer has no room, in order of arrival
+static struct rx_record *held[CONFIG_RX_POOL_SIZE];
+static int held_count;
+
+// Held records are forwarded in weighted fair order (self-clocked fair queuing)
+// Each forwarded packet advances the virtual time of its tracker by FORWARD_VTIME_SCALE / weight
+#define FORWARD_VTIME_SCALE 0x10000
+
+static uint8_t tracker_weight[MAX_TRACKERS]; // 0 is FORWARD_WEIGHT_DEFAULT
+static uint32_t tracker_vtime[MAX_TRACKERS]; // finish tag of the last forwarded packet
+static uint32_t vtime; // finish tag of the last forwarded packet of any tracker
+
+LOG_MODULE_REGISTER(forward, LOG_LEVEL_INF);
+
+static void forward_thread(void);
+K_THREAD_DEFINE(forward_thread_id, 1024, forward_thread, NULL, NULL, NULL, K_PRIO_COOP(7), 0, 0);
+
+// Called from the radio ISR, NULL if all slots are in use
+RX_HOT struct rx_record *forward_alloc(void)
+{
+	struct rx_record *record;
+	if (k_mem_slab_alloc(&rx_pool, (void **)&record, K_NO_WAIT))
+		return NULL;
+	return record;
+}
+
+RX_HOT void forward_free(struct rx_record *record)
+{
+	k_mem_slab_free(&rx_pool, record);
+}
+
+// Takes ownership of the record
+RX_HOT void forward_submit(struct rx_record *record)
+{
+	k_fifo_put(&forward_fifo, record);
+}
+
+static int forward_packet(struct rx_record *record)
+{
+	uint8_t imu_id = record->payload.data[1];
+	uint32_t profile_cycles = profile_start();
+	// hid_tx, stats and predict lock their own state, the timestamps are only written from this thread
+	int err = hid_tx_write(record->payload.data, record->payload.rssi); // copied into a report
+	if (!err)
+	{
+		sys_boot_phase(SYS_BOOT_FIRST_PACKET);
+		timestamp_forward(imu_id, record->timestamp);
+		stats_count(STATS_HID_FORWARDED);
+		stats_tracker_packet(imu_id, record->payload.rssi);
+		stats_latency(record->rx_cycles);
+		predict_update(imu_id, record->payload.data, record->rx_cycles);
+	}
+	profile_end(PROFILE_FORWARD, profile_cycles);
+	return err;
+}
+
+// Only called with records held if the hid layer is full
+// A newer packet of the same type from the same tracker then replaces the held one
+static void forward_hold(struct rx_record *record)
+{
+	for (int i = 0; i < held_count; i++)
+	{
+		if (held[i]->payload.data[0] != record->payload.data[0] || held[i]->payload.data[1] != record->payload.data[1])
+			continue;
+		forward_free(held[i]);
+		held[i] = record;
+		stats_count(STATS_USB_COALESCED);
+		return;
+	}
+	held[held_count++] = record;
+}
+
+uint8_t forward_get_weight(uint8_t imu_id)
+{
+	if (imu_id >= MAX_TRACKERS || !tracker_weight[imu_id])
+		return FORWARD_WEIGHT_DEFAULT;
+	return tracker_weight[imu_id];
+}
+
+int forward_set_weight(uint8_t imu_id, uint8_t weight)
+{
+	if (imu_id >= MAX_TRACKERS || !weight)
+		return -EINVAL;
+	tracker_weight[imu_id] = weight;
+	sys_write(STORED_TRACKER_WEIGHT, retained->tracker_weight, tracker_weight, sizeof(tracker_weight));
+	return 0;
+}
+
+static uint32_t forward_tag(uint8_t imu_id)
+{
+	uint32_t start = tracker_vtime[imu_id];
+	if ((int32_t)(start - vtime) < 0) // idle trackers do not save up credit
+		start = vtime;
+	return start + FORWARD_VTIME_SCALE / forward_get_weight(imu_id);
+}
+
+// Held record with the smallest finish tag, the oldest one on ties
+static int forward_pick(uint32_t *tag)
+{
+	int next = 0;
+	*tag = forward_tag(held[0]->payload.data[1]);
+	for (int i = 1; i < held_count; i++)
+	{
+		uint32_t t = forward_tag(held[i]->payload.data[1]);
+		if ((int32_t)(t - *tag) < 0)
+		{
+			next = i;
+			*tag = t;
+		}
+	}
+	return next;
+}
+
+static void forward_flush(void)
+{
+	while (held_count)
+	{
+		uint32_t tag;
+		int next = forward_pick(&tag);
+		struct rx_record *record = held[next];
+		if (forward_packet(record))
+			break;
+		tracker_vtime[record->payload.data[1]] = tag;
+		vtime = tag;
+		forward_free(record);
+		held_count--;
+		memmove(&held[next], &held[next + 1], (held_count - next) * sizeof(held[0]));
+	}
+}
+
+static void forward_thread(void)
+{
+	struct rx_record *record;
+	if (retained_valid())
+	{
+		memcpy(tracker_weight, retained->tracker_weight, sizeof(tracker_weight));
+	}
+	else
+	{
+		sys_read(STORED_TRACKER_WEIGHT, tracker_weight, sizeof(tracker_weight));
+		memcpy(retained->tracker_weight, tracker_weight, sizeof(tracker_weight));
+		retained_loaded(RETAINED_WEIGHTS);
+	}
+	while (1)
+	{
+		if (held_count) // the hid layer is full, collect packets until it has room again
+		{
+			hid_tx_wait(K_MSEC(1));
+			record = k_fifo_get(&forward_fifo, K_NO_WAIT);
+		}
+		else
+		{
+			record = k_fifo_get(&forward_fifo, K_FOREVER);
+		}
+		do
+		{
+			if (record)
+				forward_hold(record);
+			forward_flush();
+		} while ((record = k_fifo_get(&forward_fifo, K_NO_WAIT)));
+		if (!held_count) // all packets were written, send their arrival times too
+			timestamp_flush();
+	}
+}
+
+#if CONFIG_SHELL
+static int cmd_trackers_weight(const struct shell *sh, size_t argc, char **argv)
+{
+	if (argc == 1)
+	{
+		shell_print(sh, "%3s %6s", "id", "weight");
+		for (int i = 0; i < stored_trackers && i < MAX_TRACKERS; i++)
+			shell_print(sh, "%3d %6u", i, forward_get_weight(i));
+		return 0;
+	}
+	long imu_id = strtol(argv[1], NULL, 10);
+	long weight = argc > 2 ? strtol(argv[2], NULL, 10) : FORWARD_WEIGHT_DEFAULT;
+	if (imu_id < 0 || imu_id >= stored_trackers || weight < 1 || weight > UINT8_MAX || forward_set_weight(imu_id, weight))
+	{
+		shell_error(sh, "Invalid tracker id or weight");
+		return -EINVAL;
+	}
+	shell_print(sh, "Tracker %ld weight %ld", imu_id, weight);
+	return 0;
+}
+
+SHELL_SUBCMD_ADD((trackers), weight, NULL, "Show or set the forwarding weight of a tracker: [id] [weight 1-255]", cmd_trackers_weight, 1, 2);
+#endif
@@ -0,0 +1,48 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_FORWARD
+#define SLIMENRF_FORWARD
+
+#include <stdint.h>
+#include <esb.h>
+
+// Received packet, read by the radio directly into a pool slot and passed to the forwarding thread
+// by reference, which copies the payload into a HID report
+struct rx_record {
+	void *fifo_reserved; // used by k_fifo
+	struct esb_payload payload;
+	uint32_t rx_cycles; // cycle count at the radio event
+	uint32_t timestamp; // radio address match (us), if CONFIG_RX_TIMESTAMP
+};
+
+// Share of the HID bandwidth a tracker gets while the HID layer is full, relative to the others
+#define FORWARD_WEIGHT_DEFAULT 4
+
+struct rx_record *forward_alloc(void);
+void forward_free(struct rx_record *record);
+void forward_submit(struct rx_record *record);
+
+uint8_t forward_get_weight(uint8_t imu_id);
+int forward_set_weight(uint8_t imu_id, uint8_t weight);
+
+#endif
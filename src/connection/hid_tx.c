@@ -0,0 +1,296 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/math_extras.h>
+#include <zephyr/usb/class/usb_hid.h>
+
+#include "system/system.h"
+#include "esb_packet.h"
+#include "stats.h"
+#include "hid_tx.h"
+
+#if CONFIG_HID_TX
+
+struct hid_tx_report {
+	void *fifo_reserved; // used by k_fifo
+	uint8_t count;
+	uint8_t data[HID_TX_REPORT_PACKETS][HID_TX_PACKET_SIZE];
+};
+
+K_MEM_SLAB_DEFINE_STATIC(report_pool, sizeof(struct hid_tx_report), CONFIG_HID_TX_BUFFERS, 4);
+static K_FIFO_DEFINE(report_fifo); // filled reports, in order
+static K_SEM_DEFINE(report_pending, 0, 1); // a packet was written
+static K_SEM_DEFINE(report_free, 0, 1); // a report buffer was freed
+static K_SEM_DEFINE(ep_idle, 1, 1); // the IN endpoint can take the next transfer
+
+static struct hid_tx_report *filling; // report being filled, not yet queued
+static const struct device *hdev;
+static bool usb_suspended = false;
+static bool usb_stale = false; // queued reports are from before a suspend
+static struct k_spinlock hid_tx_lock; // staging and the report being filled, also used from the USB ISR
+
+#define HID_TX_TIMEOUT_MS 100 // assume the transfer was lost if not completed
+
+LOG_MODULE_REGISTER(hid_tx, LOG_LEVEL_INF);
+
+static void hid_tx_thread(void);
+K_THREAD_DEFINE(hid_tx_thread_id, 512, hid_tx_thread, NULL, NULL, NULL, K_PRIO_COOP(6), 0, 0);
+
+#if CONFIG_HID_TX_SOF
+struct hid_tx_packet {
+	uint8_t data[HID_TX_PACKET_SIZE];
+	uint8_t rssi;
+};
+
+#define HID_TX_SOF_OTHER (CONFIG_HID_TX_BUFFERS * HID_TX_REPORT_PACKETS)
+
+static struct hid_tx_packet sof_tracker[MAX_TRACKERS]; // freshest packet per imu_id
+static uint32_t sof_tracker_pending[DIV_ROUND_UP(MAX_TRACKERS, 32)];
+static struct hid_tx_packet sof_other[HID_TX_SOF_OTHER]; // receiver packets, sent after the tracker packets
+static int sof_other_count;
+#endif
+
+// Append to the report being filled, called with hid_tx_lock held
+static int hid_tx_append(const uint8_t *data, uint8_t rssi)
+{
+	if (!filling && k_mem_slab_alloc(&report_pool, (void **)&filling, K_NO_WAIT))
+	{
+		filling = NULL;
+		return -ENOMEM;
+	}
+	uint8_t *packet = filling->data[filling->count++];
+	memcpy(packet, data, HID_TX_PACKET_SIZE);
+	if (data[0] != 1 && data[0] != 4 && data[0] < ESB_PACKET_TYPE_RESERVED) // packet 1 and 4 are full precision, no room for rssi
+		packet[15] = rssi;
+	if (filling->count == HID_TX_REPORT_PACKETS)
+	{
+		k_fifo_put(&report_fifo, filling);
+		filling = NULL;
+	}
+	return 0;
+}
+
+#if CONFIG_HID_TX_SOF
+// Keep the packet until the next start of frame, a tracker packet replaces the previous one of the same type
+static int hid_tx_stage(const uint8_t *data, uint8_t rssi)
+{
+	uint8_t imu_id = data[1];
+	struct hid_tx_packet *packet;
+	if (data[0] < ESB_PACKET_TYPE_RESERVED && imu_id < MAX_TRACKERS)
+	{
+		packet = &sof_tracker[imu_id];
+		if (sof_tracker_pending[imu_id / 32] & BIT(imu_id % 32))
+		{
+			// a staged packet of another type is sent now if there is room
+			if (packet->data[0] == data[0])
+				stats_count(STATS_SOF_COALESCED);
+			else if (hid_tx_append(packet->data, packet->rssi))
+				stats_count(STATS_USB_DROPPED);
+		}
+		sof_tracker_pending[imu_id / 32] |= BIT(imu_id % 32);
+	}
+	else
+	{
+		if (sof_other_count == HID_TX_SOF_OTHER)
+			return -ENOMEM;
+		packet = &sof_other[sof_other_count++];
+	}
+	memcpy(packet->data, data, HID_TX_PACKET_SIZE);
+	packet->rssi = rssi;
+	return 0;
+}
+
+static bool hid_tx_sof_trackers(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(sof_tracker_pending); i++)
+	{
+		while (sof_tracker_pending[i])
+		{
+			int bit = u32_count_trailing_zeros(sof_tracker_pending[i]);
+			struct hid_tx_packet *packet = &sof_tracker[i * 32 + bit];
+			if (hid_tx_append(packet->data, packet->rssi))
+				return false; // the rest stays staged
+			sof_tracker_pending[i] &= ~BIT(bit);
+		}
+	}
+	return true;
+}
+
+static void hid_tx_sof_other(void)
+{
+	int sent = 0;
+	while (sent < sof_other_count && !hid_tx_append(sof_other[sent].data, sof_other[sent].rssi))
+		sent++;
+	sof_other_count -= sent;
+	memmove(sof_other, &sof_other[sent], sof_other_count * sizeof(sof_other[0]));
+}
+
+// Called on USB start of frame, moves the staged packets into reports for the next IN transfer
+// Receiver packets go last, so timestamps are never sent before the packets they describe
+void hid_tx_sof(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&hid_tx_lock);
+	if (hid_tx_sof_trackers())
+		hid_tx_sof_other();
+	k_spin_unlock(&hid_tx_lock, key);
+	k_sem_give(&report_pending);
+	k_sem_give(&report_free);
+}
+#endif
+
+int hid_tx_write(const uint8_t *data, uint8_t rssi)
+{
+	k_spinlock_key_t key = k_spin_lock(&hid_tx_lock);
+#if CONFIG_HID_TX_SOF
+	int err = hid_tx_stage(data, rssi);
+#else
+	int err = hid_tx_append(data, rssi);
+#endif
+	k_spin_unlock(&hid_tx_lock, key);
+	if (!err && !IS_ENABLED(CONFIG_HID_TX_SOF))
+		k_sem_give(&report_pending);
+	return err;
+}
+
+// Wait until a report buffer was freed
+int hid_tx_wait(k_timeout_t timeout)
+{
+	return k_sem_take(&report_free, timeout);
+}
+
+void hid_tx_in_ready(const struct device *dev)
+{
+	k_sem_give(&ep_idle);
+}
+
+void hid_tx_usb_status(enum usb_dc_status_code status)
+{
+	switch (status)
+	{
+	case USB_DC_SUSPEND:
+	case USB_DC_DISCONNECTED:
+	case USB_DC_RESET:
+		usb_suspended = true;
+		usb_stale = true;
+		break;
+	case USB_DC_CONFIGURED:
+		sys_boot_phase(SYS_BOOT_USB);
+		// fall through
+	case USB_DC_RESUME:
+		if (!usb_suspended)
+			break;
+		usb_suspended = false;
+		k_sem_give(&ep_idle); // a transfer in flight was lost with the suspend
+		k_sem_give(&report_pending);
+		break;
+	default:
+		break;
+	}
+}
+
+// Drop everything queued before the suspend, held packets are sent next
+static void hid_tx_flush(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&hid_tx_lock);
+	struct hid_tx_report *report;
+	usb_stale = false;
+	if (filling)
+	{
+		k_fifo_put(&report_fifo, filling);
+		filling = NULL;
+	}
+	while ((report = k_fifo_get(&report_fifo, K_NO_WAIT)))
+	{
+		for (int i = 0; i < report->count; i++)
+			stats_count(STATS_USB_DROPPED);
+		k_mem_slab_free(&report_pool, report);
+	}
+	k_spin_unlock(&hid_tx_lock, key);
+	k_sem_give(&report_free);
+}
+
+// Oldest filled report, or the partial report if nothing else is queued
+static struct hid_tx_report *hid_tx_next(bool *more)
+{
+	k_spinlock_key_t key = k_spin_lock(&hid_tx_lock);
+	struct hid_tx_report *report = k_fifo_get(&report_fifo, K_NO_WAIT);
+	if (!report)
+	{
+		report = filling;
+		filling = NULL;
+	}
+	*more = !k_fifo_is_empty(&report_fifo) || filling;
+	k_spin_unlock(&hid_tx_lock, key);
+	return report;
+}
+
+static void hid_tx_submit(struct hid_tx_report *report)
+{
+	uint32_t wrote;
+	int err = -ENODEV;
+	if (!hdev)
+		hdev = device_get_binding("HID_0");
+	if (hdev)
+		err = hid_int_ep_write(hdev, (uint8_t *)report->data, report->count * HID_TX_PACKET_SIZE, &wrote);
+	if (err)
+	{
+		for (int i = 0; i < report->count; i++)
+			stats_count(STATS_USB_DROPPED);
+	}
+	else
+	{
+		stats_count(STATS_USB_REPORTS);
+	}
+	if (err)
+		k_sem_give(&ep_idle); // nothing in flight
+	k_mem_slab_free(&report_pool, report); // the endpoint keeps its own copy
+	k_sem_give(&report_free);
+}
+
+static void hid_tx_thread(void)
+{
+	bool more;
+	while (1)
+	{
+		k_sem_take(&report_pending, K_FOREVER);
+		if (usb_suspended)
+			continue; // reports wait in the pool until resume, then hid_tx_write holds packets back
+		if (usb_stale)
+			hid_tx_flush();
+		if (k_sem_take(&ep_idle, K_MSEC(HID_TX_TIMEOUT_MS)))
+			LOG_WRN("IN transfer not completed");
+		struct hid_tx_report *report = hid_tx_next(&more);
+		if (!report)
+		{
+			k_sem_give(&ep_idle);
+			continue;
+		}
+		hid_tx_submit(report);
+		if (more)
+			k_sem_give(&report_pending);
+	}
+}
+
+#endif
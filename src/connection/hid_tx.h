@@ -0,0 +1,68 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_HID_TX
+#define SLIMENRF_HID_TX
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/usb/usb_device.h>
+
+/*
+HID transmit queue
+Packets are collected into reports of up to HID_TX_REPORT_PACKETS packets from a small pool of
+report buffers. Filled reports are queued in order, and a thread writes them to the IN endpoint
+whenever the previous transfer completed. While the endpoint is busy the next report keeps
+filling, so under load reports go out full.
+If no report buffer is free, hid_tx_write returns -ENOMEM. The caller can hold packets back and
+wait for hid_tx_wait instead of dropping them.
+While the host has the device suspended or unplugged nothing is sent. On resume the stale reports
+are dropped, so the freshest packet of each tracker is the first to reach the host.
+With CONFIG_HID_TX_SOF packets are staged until the USB start of frame instead. Only the freshest
+packet of each type per imu_id is kept, and all staged packets are put into reports at once just
+before the next IN token.
+*/
+
+#define HID_TX_PACKET_SIZE 16
+#define HID_TX_REPORT_PACKETS 4
+
+#if CONFIG_HID_TX
+int hid_tx_write(const uint8_t *data, uint8_t rssi);
+int hid_tx_wait(k_timeout_t timeout);
+
+void hid_tx_in_ready(const struct device *dev); // int_in_ready callback of the HID device
+void hid_tx_usb_status(enum usb_dc_status_code status); // from the USB status callback
+#if CONFIG_HID_TX_SOF
+void hid_tx_sof(void); // on USB_DC_SOF in the USB status callback
+#else
+#define hid_tx_sof() ((void)0)
+#endif
+#else
+#include "hid.h"
+
+#define hid_tx_write(data, rssi) (hid_write_packet_n((uint8_t *)(data), rssi), 0)
+#define hid_tx_wait(timeout) (-EAGAIN)
+#define hid_tx_sof() ((void)0)
+#define hid_tx_usb_status(status) ((void)(status))
+#endif
+
+#endif
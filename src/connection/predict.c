@@ -0,0 +1,175 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <arm_math.h>
+
+#include "system/profile.h"
+#include "hid_tx.h"
+#include "stats.h"
+#include "telemetry.h"
+#include "predict.h"
+
+#if CONFIG_RX_PREDICT
+
+// Quaternions are w, x, y, z as in CMSIS-DSP
+struct predict_state {
+	float32_t q[4]; // last received orientation
+	float32_t rate[3]; // half angle rotation per us, world frame
+	uint32_t last; // cycles at the last received packet
+	uint32_t interval; // us, moving average
+	uint8_t missed; // predicted samples sent since the last packet
+	bool valid;
+};
+
+static struct predict_state predict_state[MAX_TRACKERS];
+static struct k_spinlock predict_lock; // the state is written by the forwarding and prediction threads
+
+LOG_MODULE_REGISTER(predict, LOG_LEVEL_INF);
+
+static void predict_thread(void);
+K_THREAD_DEFINE(predict_thread_id, 1024, predict_thread, NULL, NULL, NULL, 7, 0, 0);
+
+static void predict_read_quat(const uint8_t *data, float32_t *q)
+{
+	q15_t raw[4];
+	raw[0] = sys_get_le16(&data[6]); // w
+	raw[1] = sys_get_le16(&data[0]);
+	raw[2] = sys_get_le16(&data[2]);
+	raw[3] = sys_get_le16(&data[4]);
+	arm_q15_to_float(raw, q, 4);
+}
+
+static void predict_write_quat(const float32_t *q, uint8_t *data)
+{
+	q15_t raw[4];
+	arm_float_to_q15(q, raw, 4);
+	sys_put_le16(raw[1], &data[0]);
+	sys_put_le16(raw[2], &data[2]);
+	sys_put_le16(raw[3], &data[4]);
+	sys_put_le16(raw[0], &data[6]); // w
+}
+
+// Called from the forwarding thread for each forwarded tracker packet
+void predict_update(uint8_t imu_id, const uint8_t *data, uint32_t rx_cycles)
+{
+	if (imu_id >= MAX_TRACKERS || (data[0] != 1 && data[0] != 4))
+		return;
+	uint32_t profile_cycles = profile_start();
+	struct predict_state *state = &predict_state[imu_id];
+	struct predict_state last;
+	k_spinlock_key_t key = k_spin_lock(&predict_lock);
+	last = *state;
+	k_spin_unlock(&predict_lock, key);
+	float32_t q[4];
+	float32_t rate[3] = {0};
+	uint32_t interval = 0;
+	predict_read_quat(&data[2], q);
+	uint32_t dt = k_cyc_to_us_floor32(rx_cycles - last.last);
+	if (last.valid && dt > 0 && dt < CONFIG_RX_PREDICT_TIMEOUT * 1000)
+	{
+		// rotation since the last sample, q * conj(q_last)
+		float32_t conj[4];
+		float32_t delta[4];
+		arm_quaternion_conjugate_f32(last.q, conj, 1);
+		arm_quaternion_product_single_f32(q, conj, delta);
+		float32_t scale = (delta[0] < 0 ? -1.0f : 1.0f) / dt; // shortest path
+		arm_scale_f32(&delta[1], scale, rate, 3);
+		interval = last.interval;
+		if (!last.missed) // late packets would skew the interval
+			interval = interval ? interval + ((int32_t)dt - (int32_t)interval) / 8 : dt;
+	}
+	key = k_spin_lock(&predict_lock);
+	memcpy(state->q, q, sizeof(q));
+	memcpy(state->rate, rate, sizeof(rate));
+	state->interval = interval;
+	state->last = rx_cycles;
+	state->missed = 0;
+	state->valid = true;
+	k_spin_unlock(&predict_lock, key);
+	profile_end(PROFILE_PREDICT, profile_cycles);
+}
+
+// First order extrapolation, q_last rotated by rate * t
+static void predict_sample(const struct predict_state *state, uint32_t t, float32_t *q)
+{
+	float32_t step[4];
+	float32_t out[4];
+	step[0] = 1.0f;
+	arm_scale_f32(state->rate, t, &step[1], 3);
+	arm_quaternion_product_single_f32(step, state->q, out);
+	arm_quaternion_normalize_f32(out, q, 1);
+}
+
+static void predict_check(uint8_t imu_id, uint32_t now)
+{
+	struct predict_state *state = &predict_state[imu_id];
+	struct predict_state last;
+	// copy the state and count the prediction under the lock, extrapolate and write without it
+	k_spinlock_key_t key = k_spin_lock(&predict_lock);
+	if (!state->valid || !state->interval || state->missed >= CONFIG_RX_PREDICT_MAX)
+	{
+		k_spin_unlock(&predict_lock, key);
+		return;
+	}
+	uint32_t elapsed = k_cyc_to_us_floor32(now - state->last);
+	uint32_t due = state->interval * (state->missed + 1);
+	if (elapsed < due + state->interval / 2) // not late yet
+	{
+		k_spin_unlock(&predict_lock, key);
+		return;
+	}
+	last = *state;
+	state->missed++;
+	k_spin_unlock(&predict_lock, key);
+	uint32_t profile_cycles = profile_start();
+	float32_t q[4];
+	uint8_t packet[16] = {0};
+	predict_sample(&last, due, q);
+	packet[0] = TELEMETRY_PREDICTED;
+	packet[1] = TELEMETRY_ID;
+	packet[2] = imu_id;
+	predict_write_quat(q, &packet[3]);
+	packet[11] = last.missed + 1;
+	sys_put_le16(MIN(last.interval, UINT16_MAX), &packet[12]);
+	profile_end(PROFILE_PREDICT, profile_cycles);
+	if (hid_tx_write(packet, 0))
+		stats_count(STATS_USB_DROPPED);
+	else
+		stats_count(STATS_PREDICTED);
+}
+
+static void predict_thread(void)
+{
+	while (1)
+	{
+		k_msleep(1);
+		uint32_t now = k_cycle_get_32();
+		for (int i = 0; i < stored_trackers && i < MAX_TRACKERS; i++)
+			predict_check(i, now);
+	}
+}
+
+#endif
@@ -0,0 +1,45 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_PREDICT
+#define SLIMENRF_PREDICT
+
+#include <stdint.h>
+
+/*
+Prediction of late tracker samples
+Orientation is taken from tracker packets 1 and 4, bytes 2-9 are the quaternion x, y, z, w (q15).
+If the next packet of a tracker is late by half an interval, a predicted sample is sent as a
+receiver packet, so it can never be mistaken for tracker data:
+
+TELEMETRY_PREDICTED
+0 type, 1 id, 2 imu_id, 3-10 quaternion x, y, z, w (q15), 11 intervals since the last packet,
+12-13 interval (us), 14-15 reserved
+*/
+
+#if CONFIG_RX_PREDICT
+void predict_update(uint8_t imu_id, const uint8_t *data, uint32_t rx_cycles);
+#else
+#define predict_update(imu_id, data, rx_cycles) ((void)(rx_cycles))
+#endif
+
+#endif
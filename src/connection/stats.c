@@ -0,0 +1,274 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+#include "stats.h"
+
+#if CONFIG_RX_STATS
+
+static struct rx_stats stats;
+static struct tracker_stats tracker_stats[MAX_TRACKERS];
+static uint32_t tracker_packets_last[MAX_TRACKERS];
+static struct k_spinlock stats_lock; // written from the radio ISR and from threads, callers need no lock
+
+LOG_MODULE_REGISTER(stats, LOG_LEVEL_INF);
+
+static void stats_thread(void);
+K_THREAD_DEFINE(stats_thread_id, 512, stats_thread, NULL, NULL, NULL, 7, 0, 0);
+
+void stats_count(enum stats_counter counter)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	stats.counter[counter]++;
+	k_spin_unlock(&stats_lock, key);
+}
+
+void stats_latency(uint32_t start_cycles)
+{
+	uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
+	int bin = 0;
+	while (us && bin < STATS_LATENCY_BINS - 1)
+	{
+		us >>= 1;
+		bin++;
+	}
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	stats.latency_hist[bin]++;
+	k_spin_unlock(&stats_lock, key);
+}
+
+void stats_rx_fifo(uint32_t count)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	if (count > stats.rx_fifo_hwm)
+		stats.rx_fifo_hwm = count;
+	k_spin_unlock(&stats_lock, key);
+}
+
+void stats_tracker_packet(uint8_t imu_id, int8_t rssi)
+{
+	if (imu_id >= MAX_TRACKERS)
+		return;
+	struct tracker_stats *tracker = &tracker_stats[imu_id];
+	int8_t dbm = -rssi;
+	uint32_t now = k_uptime_get_32();
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	if (!tracker->packets)
+	{
+		tracker->rssi_avg = dbm * 16;
+		tracker->rssi_min = dbm;
+	}
+	else
+	{
+		tracker->rssi_avg += (dbm * 16 - tracker->rssi_avg) / 8;
+		if (dbm < tracker->rssi_min)
+			tracker->rssi_min = dbm;
+	}
+	tracker->packets++;
+	tracker->last_packet = now;
+	k_spin_unlock(&stats_lock, key);
+}
+
+void stats_tracker_drop(enum stats_counter counter, uint8_t imu_id)
+{
+	if (imu_id >= MAX_TRACKERS)
+		return;
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	if (counter == STATS_FILTER_DROPPED)
+		tracker_stats[imu_id].filtered++;
+	else if (counter == STATS_RESERVED_DROPPED)
+		tracker_stats[imu_id].reserved++;
+	else if (counter == STATS_DUPLICATE_DROPPED)
+		tracker_stats[imu_id].duplicates++;
+	k_spin_unlock(&stats_lock, key);
+}
+
+void stats_tracker_loss(uint8_t imu_id, int lost)
+{
+	if (imu_id >= MAX_TRACKERS || lost <= 0)
+		return;
+	struct tracker_stats *tracker = &tracker_stats[imu_id];
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	stats.counter[STATS_RADIO_LOST] += lost;
+	tracker->lost += lost;
+	tracker->loss_runs++;
+	if (lost > tracker->loss_run_max)
+		tracker->loss_run_max = lost;
+	k_spin_unlock(&stats_lock, key);
+}
+
+void stats_get(struct rx_stats *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	memcpy(out, &stats, sizeof(stats));
+	k_spin_unlock(&stats_lock, key);
+}
+
+void stats_get_tracker(uint8_t imu_id, struct tracker_stats *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	memcpy(out, &tracker_stats[imu_id], sizeof(*out));
+	k_spin_unlock(&stats_lock, key);
+}
+
+void stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	memset(&stats, 0, sizeof(stats));
+	memset(tracker_stats, 0, sizeof(tracker_stats));
+	memset(tracker_packets_last, 0, sizeof(tracker_packets_last));
+	k_spin_unlock(&stats_lock, key);
+}
+
+// upper bound in us of the bin containing the given percentile
+static uint32_t stats_percentile(const uint32_t *hist, int percent)
+{
+	uint32_t total = 0;
+	for (int i = 0; i < STATS_LATENCY_BINS; i++)
+		total += hist[i];
+	if (!total)
+		return 0;
+	uint32_t target = (total * percent + 99) / 100;
+	uint32_t sum = 0;
+	for (int i = 0; i < STATS_LATENCY_BINS; i++)
+	{
+		sum += hist[i];
+		if (sum >= target)
+			return 1 << i;
+	}
+	return 1 << (STATS_LATENCY_BINS - 1);
+}
+
+static void stats_update_rate(void)
+{
+	for (int i = 0; i < MAX_TRACKERS; i++)
+	{
+		k_spinlock_key_t key = k_spin_lock(&stats_lock);
+		uint32_t packets = tracker_stats[i].packets;
+		tracker_stats[i].rate = packets - tracker_packets_last[i];
+		tracker_packets_last[i] = packets;
+		k_spin_unlock(&stats_lock, key);
+	}
+}
+
+static void stats_thread(void)
+{
+	struct rx_stats last = {0};
+	struct rx_stats now;
+	struct rx_stats delta;
+	int64_t time = k_uptime_get();
+	int seconds = 0;
+	while (1)
+	{
+		time += 1000;
+		k_sleep(K_TIMEOUT_ABS_MS(time));
+		stats_update_rate();
+		if (++seconds < CONFIG_RX_STATS_INTERVAL)
+			continue;
+		seconds = 0;
+		stats_get(&now);
+		for (int i = 0; i < STATS_COUNTER_COUNT; i++)
+			delta.counter[i] = now.counter[i] - last.counter[i];
+		for (int i = 0; i < STATS_LATENCY_BINS; i++)
+			delta.latency_hist[i] = now.latency_hist[i] - last.latency_hist[i];
+		last = now;
+		if (!delta.counter[STATS_RADIO_RECEIVED])
+			continue;
+		LOG_INF("irq %u/s, rx %u/s, hid %u/s, usb %u reports/s, drop radio %u filter %u reserved %u duplicate %u usb %u, lost %u, coalesced %u, sof coalesced %u, predicted %u, slips %u, latency p50 %uus p90 %uus p99 %uus",
+				delta.counter[STATS_RADIO_EVENT] / CONFIG_RX_STATS_INTERVAL,
+				delta.counter[STATS_RADIO_RECEIVED] / CONFIG_RX_STATS_INTERVAL,
+				delta.counter[STATS_HID_FORWARDED] / CONFIG_RX_STATS_INTERVAL,
+				delta.counter[STATS_USB_REPORTS] / CONFIG_RX_STATS_INTERVAL,
+				delta.counter[STATS_RADIO_ERROR],
+				delta.counter[STATS_FILTER_DROPPED],
+				delta.counter[STATS_RESERVED_DROPPED],
+				delta.counter[STATS_DUPLICATE_DROPPED],
+				delta.counter[STATS_USB_DROPPED],
+				delta.counter[STATS_RADIO_LOST],
+				delta.counter[STATS_USB_COALESCED],
+				delta.counter[STATS_SOF_COALESCED],
+				delta.counter[STATS_PREDICTED],
+				delta.counter[STATS_FRAME_SLIP],
+				stats_percentile(delta.latency_hist, 50),
+				stats_percentile(delta.latency_hist, 90),
+				stats_percentile(delta.latency_hist, 99));
+	}
+}
+
+#if CONFIG_SHELL
+static int cmd_trackers_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	struct tracker_stats tracker;
+	uint32_t now = k_uptime_get_32();
+	shell_print(sh, "%3s %6s %5s %8s %8s %8s %8s %8s %8s %6s %3s %8s", "id", "pkt/s", "rssi", "rssi min", "packets", "filtered", "reserved", "dups", "lost", "runs", "max", "last ms");
+	for (int i = 0; i < MAX_TRACKERS; i++)
+	{
+		stats_get_tracker(i, &tracker);
+		if (i >= stored_trackers && !tracker.packets && !tracker.filtered && !tracker.reserved && !tracker.duplicates)
+			continue;
+		if (!tracker.packets)
+		{
+			shell_print(sh, "%3d %6u %5s %8s %8u %8u %8u %8u %8u %6u %3u %8s", i, 0, "-", "-", 0, tracker.filtered, tracker.reserved, tracker.duplicates, tracker.lost, tracker.loss_runs, tracker.loss_run_max, "-");
+			continue;
+		}
+		shell_print(sh, "%3d %6u %5d %8d %8u %8u %8u %8u %8u %6u %3u %8u", i, tracker.rate, tracker.rssi_avg / 16, tracker.rssi_min, tracker.packets, tracker.filtered, tracker.reserved, tracker.duplicates, tracker.lost, tracker.loss_runs, tracker.loss_run_max, now - tracker.last_packet);
+	}
+	return 0;
+}
+
+static int cmd_trackers_summary(const struct shell *sh, size_t argc, char **argv)
+{
+	static const char *const counter_names[] = {
+		"radio events", "radio received", "radio errors", "filter dropped", "reserved dropped",
+		"duplicate dropped", "hid forwarded", "usb dropped", "usb reports", "usb coalesced",
+		"sof coalesced", "predicted", "frame slips", "radio lost",
+	};
+	BUILD_ASSERT(ARRAY_SIZE(counter_names) == STATS_COUNTER_COUNT);
+	struct rx_stats now;
+	stats_get(&now);
+	for (int i = 0; i < STATS_COUNTER_COUNT; i++)
+		shell_print(sh, "%-18s %10u", counter_names[i], now.counter[i]);
+	shell_print(sh, "%-18s %10u", "rx fifo hwm", now.rx_fifo_hwm);
+	shell_print(sh, "latency p50 %uus p90 %uus p99 %uus",
+				stats_percentile(now.latency_hist, 50),
+				stats_percentile(now.latency_hist, 90),
+				stats_percentile(now.latency_hist, 99));
+	return 0;
+}
+
+static int cmd_trackers_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	stats_reset();
+	shell_print(sh, "Statistics reset");
+	return 0;
+}
+
+SHELL_SUBCMD_ADD((trackers), stats, NULL, "Show per tracker link statistics", cmd_trackers_stats, 1, 0);
+SHELL_SUBCMD_ADD((trackers), summary, NULL, "Show receive path counters since the last reset", cmd_trackers_summary, 1, 0);
+SHELL_SUBCMD_ADD((trackers), reset, NULL, "Reset link statistics", cmd_trackers_reset, 1, 0);
+#endif
+
+#endif
@@ -0,0 +1,93 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_STATS
+#define SLIMENRF_STATS
+
+#include <stdint.h>
+
+// Stages of the receive path, in order
+enum stats_counter {
+	STATS_RADIO_EVENT, // ESB RX interrupts
+	STATS_RADIO_RECEIVED, // read from the ESB RX FIFO
+	STATS_RADIO_ERROR, // esb_read_rx_payload failed
+	STATS_FILTER_DROPPED, // unknown or not yet discovered imu_id
+	STATS_RESERVED_DROPPED, // packet type reserved for the receiver
+	STATS_DUPLICATE_DROPPED, // retransmit of a packet already received
+	STATS_HID_FORWARDED, // handed to the HID layer
+	STATS_USB_DROPPED, // discarded by the HID layer before reaching the host
+	STATS_USB_REPORTS, // HID IN transfers
+	STATS_USB_COALESCED, // replaced by a newer packet while the HID layer was full
+	STATS_SOF_COALESCED, // replaced by a newer packet while staged for the next start of frame
+	STATS_PREDICTED, // predicted samples sent for late tracker packets
+	STATS_FRAME_SLIP, // radio timer handled a frame switch late
+	STATS_RADIO_LOST, // tracker packets never received, from gaps in the packet id
+	STATS_COUNTER_COUNT
+};
+
+// Latency histogram, bin n counts latencies in [2^(n-1), 2^n) us
+#define STATS_LATENCY_BINS 16
+
+struct rx_stats {
+	uint32_t counter[STATS_COUNTER_COUNT];
+	uint32_t latency_hist[STATS_LATENCY_BINS];
+	uint32_t rx_fifo_hwm; // most packets read from the RX FIFO in one event
+};
+
+// Per imu_id link statistics
+struct tracker_stats {
+	uint32_t packets; // forwarded to the HID layer
+	uint32_t filtered; // dropped by the garbage filter
+	uint32_t reserved; // dropped for using a reserved packet type
+	uint32_t duplicates; // dropped as a retransmit
+	uint32_t lost; // missing from gaps in the packet id
+	uint32_t loss_runs; // gaps of one or more lost packets
+	uint8_t loss_run_max; // longest gap seen, at most 3
+	uint32_t last_packet; // uptime (ms) of the last forwarded packet
+	uint16_t rate; // forwarded packets in the last second
+	int16_t rssi_avg; // moving average, dBm * 16
+	int8_t rssi_min; // dBm
+};
+
+#if CONFIG_RX_STATS
+// Safe from ISRs and threads, the counters are locked inside
+void stats_count(enum stats_counter counter);
+void stats_latency(uint32_t start_cycles);
+void stats_rx_fifo(uint32_t count);
+
+void stats_tracker_packet(uint8_t imu_id, int8_t rssi); // rssi as reported by ESB (-dBm)
+void stats_tracker_drop(enum stats_counter counter, uint8_t imu_id);
+void stats_tracker_loss(uint8_t imu_id, int lost);
+
+void stats_get(struct rx_stats *out);
+void stats_get_tracker(uint8_t imu_id, struct tracker_stats *out);
+void stats_reset(void);
+#else
+#define stats_count(counter) ((void)0)
+#define stats_latency(start_cycles) ((void)(start_cycles))
+#define stats_rx_fifo(count) ((void)(count))
+#define stats_tracker_packet(imu_id, rssi) ((void)0)
+#define stats_tracker_drop(counter, imu_id) ((void)0)
+#define stats_tracker_loss(imu_id, lost) ((void)(lost))
+#endif
+
+#endif
@@ -0,0 +1,95 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "hid_tx.h"
+#include "stats.h"
+#include "telemetry.h"
+
+#if CONFIG_RX_TELEMETRY
+
+LOG_MODULE_REGISTER(telemetry, LOG_LEVEL_INF);
+
+static void telemetry_thread(void);
+K_THREAD_DEFINE(telemetry_thread_id, 512, telemetry_thread, NULL, NULL, NULL, 7, 0, 0);
+
+static void telemetry_write(uint8_t *packet)
+{
+	for (int retry = 0; retry < 3; retry++)
+	{
+		int err = hid_tx_write(packet, 0); // locks the hid layer against the other writers
+		if (!err)
+			return;
+		hid_tx_wait(K_MSEC(2)); // reports are sent in a burst, wait for room
+	}
+	stats_count(STATS_USB_DROPPED);
+}
+
+static void telemetry_write_receiver(void)
+{
+	struct rx_stats stats;
+	uint8_t packet[16] = {0};
+	stats_get(&stats);
+	packet[0] = TELEMETRY_RECEIVER;
+	packet[1] = TELEMETRY_ID;
+	sys_put_le32(k_uptime_get_32(), &packet[2]);
+	sys_put_le32(stats.counter[STATS_FRAME_SLIP], &packet[6]);
+	sys_put_le32(stats.counter[STATS_USB_DROPPED], &packet[10]);
+	packet[14] = MIN(stats.rx_fifo_hwm, UINT8_MAX);
+	packet[15] = MIN(stored_trackers, UINT8_MAX);
+	telemetry_write(packet);
+}
+
+static void telemetry_write_tracker(uint8_t imu_id)
+{
+	struct tracker_stats tracker;
+	uint8_t packet[16] = {0};
+	stats_get_tracker(imu_id, &tracker);
+	packet[0] = TELEMETRY_TRACKER;
+	packet[1] = TELEMETRY_ID;
+	packet[2] = imu_id;
+	sys_put_le16(tracker.rate, &packet[3]);
+	sys_put_le32(tracker.packets, &packet[5]);
+	sys_put_le16(MIN(tracker.filtered, UINT16_MAX), &packet[9]);
+	packet[11] = tracker.rssi_avg / 16;
+	packet[12] = tracker.rssi_min;
+	sys_put_le16(MIN(tracker.lost, UINT16_MAX), &packet[13]);
+	packet[15] = MIN(tracker.duplicates, UINT8_MAX);
+	telemetry_write(packet);
+}
+
+static void telemetry_thread(void)
+{
+	while (1)
+	{
+		k_msleep(CONFIG_RX_TELEMETRY_INTERVAL);
+		telemetry_write_receiver();
+		for (int i = 0; i < stored_trackers && i < MAX_TRACKERS; i++)
+			telemetry_write_tracker(i);
+	}
+}
+
+#endif
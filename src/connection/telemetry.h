@@ -0,0 +1,51 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_TELEMETRY
+#define SLIMENRF_TELEMETRY
+
+#include "esb_packet.h"
+
+/*
+Receiver telemetry, sent in the HID stream using packet types reserved for the receiver
+All values are little endian, byte 1 is always TELEMETRY_ID
+
+TELEMETRY_RECEIVER
+0 type, 1 id, 2-5 uptime (ms), 6-9 frame slips, 10-13 usb drops, 14 rx fifo high-water mark, 15 stored trackers
+
+TELEMETRY_TRACKER
+0 type, 1 id, 2 imu_id, 3-4 packets/s, 5-8 forwarded packets, 9-10 filtered packets, 11 rssi average (dBm), 12 rssi minimum (dBm),
+13-14 lost packets, 15 dropped retransmits (both saturating)
+
+TELEMETRY_TIMESTAMP
+0 type, 1 id, 2 count, 3-6 base timestamp (us), 7-15 up to 3 entries of imu_id, offset from base (us, 2 bytes)
+Sent after the tracker packets it describes, the timestamp is the radio address match of each packet
+*/
+
+#define TELEMETRY_RECEIVER (ESB_PACKET_TYPE_RESERVED + 0)
+#define TELEMETRY_TRACKER (ESB_PACKET_TYPE_RESERVED + 1)
+#define TELEMETRY_TIMESTAMP (ESB_PACKET_TYPE_RESERVED + 2)
+#define TELEMETRY_PREDICTED (ESB_PACKET_TYPE_RESERVED + 3) // see predict.h
+
+#define TELEMETRY_ID 255 // never given to a tracker (esb.c pairs up to 255), so the packet is not merged with tracker data
+
+#endif
@@ -21,34 +21,130 @@
 	THE SOFTWARE.
 */
 #include "globals.h"
+#include "system/profile.h"
 #include "esb.h"
+#include "esb_packet.h"
+#include "stats.h"
+#include "coexist.h"
+#include "channel_scan.h"
+#include "timer.h"
 
 #include <nrfx_timer.h>
 
 const nrfx_timer_t m_timer = NRFX_TIMER_INSTANCE(1);
 uint16_t led_clock = 0;
 
+static uint32_t frame_count = 0;
+static uint32_t frame_time = 0; // receiver time at the start of the current frame (us)
+static uint32_t frame_period;
+static uint32_t frame_length; // differs from frame_period while shifting phase
+static uint32_t frame_shift = 0;
+
+static uint32_t frame_slot_ticks;
+static bool timer_started = false;
+
+#define TIMER_ANNOUNCE_FRAMES 50 // beacons announcing a new frame period before it applies
+
+static uint32_t frame_period_next;
+static uint32_t frame_slot_next;
+static int frame_countdown = -1; // beacons left announcing frame_period_next, -1 if no change is pending
+static bool frame_apply = false; // the next frame starts with frame_period_next
+
+static enum coexist_frame coexist_state = COEXIST_FRAME_NORMAL;
+
 LOG_MODULE_REGISTER(timer, 4);
 
-void timer_handler(nrf_timer_event_t event_type, void *p_context) {
+#if CONFIG_RX_ADAPTIVE_FRAME
+static void timer_adapt_thread(void);
+K_THREAD_DEFINE(timer_adapt_thread_id, 768, timer_adapt_thread, NULL, NULL, NULL, 7, 0, 0);
+#endif
+
+// count a slip if the switch is handled more than one slot after its compare point
+static void timer_check_slip(nrf_timer_cc_channel_t channel) {
+#if CONFIG_RX_STATS
+	uint32_t now = nrfx_timer_capture(&m_timer, NRF_TIMER_CC_CHANNEL3);
+	if (now - nrfx_timer_capture_get(&m_timer, channel) > frame_slot_ticks)
+		stats_count(STATS_FRAME_SLIP);
+#endif
+}
+
+// Sync for the frame starting next, with the announced frame period while a change is pending
+static void timer_write_sync(void) {
+	uint32_t next_period = frame_period;
+	uint32_t next_slot = frame_slot_ticks;
+	uint8_t countdown = 0;
+	if (frame_countdown >= 0) {
+		next_period = frame_period_next;
+		next_slot = frame_slot_next;
+		countdown = frame_countdown;
+		if (!frame_countdown--)
+			frame_apply = true;
+	}
+	esb_write_sync(led_clock, frame_count + 1, frame_time + frame_length, frame_apply ? next_period : frame_period,
+			next_period, countdown, next_slot);
+}
+
+static void timer_set_frame(uint32_t length) {
+	nrfx_timer_extended_compare(&m_timer, NRF_TIMER_CC_CHANNEL0, length, NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK, true); // timeslot to send sync
+	nrfx_timer_compare(&m_timer, NRF_TIMER_CC_CHANNEL1, length - frame_slot_ticks, true); // switch to tx
+}
+
+RX_HOT void timer_handler(nrf_timer_event_t event_type, void *p_context) {
+	uint32_t profile_cycles = profile_start();
 	if (event_type == NRF_TIMER_EVENT_COMPARE0) {
 		//esb_write_sync(led_clock);
-		esb_start_tx();
+		if (coexist_state != COEXIST_FRAME_LISTEN)
+			esb_start_tx();
+		frame_count++;
+		frame_time += frame_length;
+		bool apply = frame_apply;
+		if (apply) { // announced in the previous beacons
+			frame_apply = false;
+			frame_period = frame_period_next;
+			frame_slot_ticks = frame_slot_next;
+			nrfx_timer_compare(&m_timer, NRF_TIMER_CC_CHANNEL2, frame_slot_ticks, true); // switch to rx
+			timer_update_slot(); // a profile or command mode change during the announcement was not taken
+		}
+		if (apply || frame_shift || frame_length != frame_period) { // stretch one frame to move the phase
+			frame_length = frame_period + frame_shift;
+			frame_shift = 0;
+			timer_set_frame(frame_length);
+		}
+		profile_end(PROFILE_TIMER_COMPARE0, profile_cycles);
 	} else if (event_type == NRF_TIMER_EVENT_COMPARE1) {
-		esb_stop_rx();
-		esb_disable();
-		esb_initialize(true);
-		esb_write_sync(led_clock);
+		timer_check_slip(NRF_TIMER_CC_CHANNEL1);
+		if (coexist_state != COEXIST_FRAME_LISTEN) { // keep listening for other receivers
+			esb_stop_rx();
+			esb_disable();
+			esb_set_rendezvous(coexist_state == COEXIST_FRAME_ANNOUNCE);
+			esb_initialize(true);
+			if (coexist_state == COEXIST_FRAME_ANNOUNCE)
+				coexist_write_beacon(frame_period, frame_slot_ticks);
+			else
+				timer_write_sync();
+		}
+		profile_end(PROFILE_TIMER_COMPARE1, profile_cycles);
 	} else if (event_type == NRF_TIMER_EVENT_COMPARE2) {
+		timer_check_slip(NRF_TIMER_CC_CHANNEL2);
+		coexist_state = coexist_frame_type(frame_count);
+		esb_set_rendezvous(coexist_state == COEXIST_FRAME_LISTEN);
 		esb_disable();
+		channel_scan_step(); // a running scan takes the start of the rx window
 		esb_initialize(false);
 		esb_start_rx();
 		led_clock++;
 		led_clock%=17*600/3;
+		profile_end(PROFILE_TIMER_COMPARE2, profile_cycles);
 	}
+	profile_end(PROFILE_TIMER, profile_cycles);
 }
 
+// Once the receiver is paired, later calls do nothing
 void timer_init(void) {
+	if (timer_started) {
+		return;
+	}
+	timer_started = true;
     //nrfx_err_t err;
 	nrfx_timer_config_t timer_cfg = NRFX_TIMER_DEFAULT_CONFIG(1000000);
 	//timer_cfg.frequency = NRF_TIMER_FREQ_1MHz;
@@ -58,10 +154,97 @@ void timer_init(void) {
     //timer_cfg.p_context = NULL;
 	nrfx_timer_init(&m_timer, &timer_cfg, timer_handler);
     uint32_t ticks = nrfx_timer_ms_to_ticks(&m_timer, 3);
-    nrfx_timer_extended_compare(&m_timer, NRF_TIMER_CC_CHANNEL0, ticks, NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK, true); // timeslot to send sync
-    nrfx_timer_compare(&m_timer, NRF_TIMER_CC_CHANNEL1, ticks * 20 / 21, true); // switch to tx
-    nrfx_timer_compare(&m_timer, NRF_TIMER_CC_CHANNEL2, ticks * 1 / 21, true); // switch to rx
+	frame_slot_ticks = esb_tx_slot();
+	frame_period = ticks; // 1MHz
+	frame_length = ticks;
+	timer_set_frame(ticks);
+    nrfx_timer_compare(&m_timer, NRF_TIMER_CC_CHANNEL2, frame_slot_ticks, true); // switch to rx
     nrfx_timer_enable(&m_timer);
 	IRQ_DIRECT_CONNECT(TIMER1_IRQn, 0, nrfx_timer_1_irq_handler, 0);
 	irq_enable(TIMER1_IRQn);
 }
+
+// Time since the start of the current frame (us)
+uint32_t timer_frame_offset(void) {
+	unsigned int key = irq_lock();
+	uint32_t offset = nrfx_timer_capture(&m_timer, NRF_TIMER_CC_CHANNEL3);
+	irq_unlock(key);
+	return offset;
+}
+
+uint32_t timer_frame_period(void) {
+	return frame_period;
+}
+
+// The tx slot spans this long before and after the start of a frame (us)
+uint32_t timer_frame_slot(void) {
+	return frame_slot_ticks;
+}
+
+// Delay the start of the next frame, the frame is stretched once
+void timer_shift_phase(uint32_t us) {
+	frame_shift = us % frame_period;
+}
+
+// Announce a new frame period and tx slot (us) to trackers, applied after TIMER_ANNOUNCE_FRAMES beacons
+void timer_request_frame(uint32_t period, uint32_t slot) {
+	unsigned int key = irq_lock();
+	if (frame_countdown < 0 && !frame_apply) {
+		frame_period_next = period;
+		frame_slot_next = slot;
+		frame_countdown = TIMER_ANNOUNCE_FRAMES;
+	}
+	irq_unlock(key);
+}
+
+// Size the tx slot for the radio profile, after it changes or a change is announced
+void timer_update_slot(void) {
+	if (!timer_started) // timer_init sizes it
+		return;
+	uint32_t slot = esb_tx_slot();
+	if (slot != frame_slot_ticks)
+		timer_request_frame(frame_period, slot);
+}
+
+#if CONFIG_RX_ADAPTIVE_FRAME
+#define TIMER_PACKET_AIRTIME 250 // us per tracker packet and ack at 2Mbit, including ramp-up
+#define TIMER_AIRTIME_HEADROOM 2 // room for retransmits and collisions
+#define TIMER_RX_MAX_PERMILLE 950
+#define TIMER_PERIOD_STEP 250 // us
+#define TIMER_PERIOD_HYSTERESIS 5 // change when the period differs by more than 1/5
+
+// Shortest frame whose rx window fits the packet rate, the tx window is fixed
+// Short frames give trackers more sync beacons and command slots, long frames more rx airtime
+uint32_t timer_adapt_period(uint32_t packet_rate, uint32_t airtime, uint32_t tx_window) {
+	uint32_t rx_permille = MIN((uint64_t)packet_rate * airtime * TIMER_AIRTIME_HEADROOM / 1000, TIMER_RX_MAX_PERMILLE);
+	uint32_t period = ROUND_UP(tx_window * 1000 / (1000 - rx_permille), TIMER_PERIOD_STEP);
+	return CLAMP(period, CONFIG_RX_ADAPTIVE_FRAME_MIN, CONFIG_RX_ADAPTIVE_FRAME_MAX);
+}
+
+static void timer_adapt_thread(void) {
+	struct tracker_stats tracker;
+	while (1) {
+		k_msleep(1000); // tracker rates are updated every second
+		uint32_t rate = 0;
+		int active = 0;
+		for (int i = 0; i < stored_trackers; i++) {
+			stats_get_tracker(i, &tracker);
+			if (tracker.rate) {
+				active++;
+				rate += tracker.rate;
+			}
+		}
+		uint32_t airtime = esb_get_radio_profile() == ESB_PROFILE_LONG_RANGE ? TIMER_PACKET_AIRTIME * 2 : TIMER_PACKET_AIRTIME;
+		uint32_t slot = esb_tx_slot(); // also shrinks the slot after a switch to a faster profile
+		uint32_t current = frame_period;
+		uint32_t period = timer_adapt_period(rate, airtime, slot * 2);
+		if (period * TIMER_PERIOD_HYSTERESIS > current * (TIMER_PERIOD_HYSTERESIS - 1) && period * TIMER_PERIOD_HYSTERESIS < current * (TIMER_PERIOD_HYSTERESIS + 1)) {
+			if (slot == frame_slot_ticks)
+				continue;
+			period = current;
+		}
+		LOG_INF("%d trackers, %u packets/s, frame period %u -> %u us, rx %u%%", active, rate, current, period, 100 - slot * 2 * 100 / period);
+		timer_request_frame(period, slot);
+	}
+}
+#endif
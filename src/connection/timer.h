@@ -28,4 +28,14 @@
 void timer_handler(nrf_timer_event_t event_type, void* p_context);
 void timer_init(void);
 
+uint32_t timer_frame_offset(void);
+uint32_t timer_frame_period(void);
+uint32_t timer_frame_slot(void);
+void timer_shift_phase(uint32_t us);
+void timer_request_frame(uint32_t period, uint32_t slot);
+void timer_update_slot(void);
+#if CONFIG_RX_ADAPTIVE_FRAME
+uint32_t timer_adapt_period(uint32_t packet_rate, uint32_t airtime, uint32_t tx_window);
+#endif
+
 #endif
@@ -0,0 +1,141 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <nrfx_timer.h>
+#include <helpers/nrfx_gppi.h>
+#include <hal/nrf_radio.h>
+
+#include "hid_tx.h"
+#include "stats.h"
+#include "telemetry.h"
+#include "timestamp.h"
+
+#if CONFIG_RX_TIMESTAMP
+
+// Free running 1MHz timer, RADIO ADDRESS of received packets is captured to CC0 through PPI
+static const nrfx_timer_t ts_timer = NRFX_TIMER_INSTANCE(3);
+
+#define TIMESTAMP_BATCH 3 // entries in one packet, a partial packet is sent once the forward FIFO is empty
+
+static uint8_t ts_packet[16];
+static uint8_t ts_count;
+static uint32_t ts_base;
+
+LOG_MODULE_REGISTER(timestamp, LOG_LEVEL_INF);
+
+static void timestamp_timer_handler(nrf_timer_event_t event_type, void *p_context)
+{
+}
+
+static int timestamp_ppi_alloc(uint8_t *ppi_ch)
+{
+	if (nrfx_gppi_channel_alloc(ppi_ch) != NRFX_SUCCESS)
+	{
+		LOG_ERR("Failed to allocate PPI channel");
+		return -ENOMEM;
+	}
+	return 0;
+}
+
+static int timestamp_init(void)
+{
+	uint8_t capture_ch, rx_ch, tx_ch;
+	nrfx_gppi_channel_group_t group;
+	nrfx_timer_config_t timer_cfg = NRFX_TIMER_DEFAULT_CONFIG(1000000);
+	timer_cfg.bit_width = NRF_TIMER_BIT_WIDTH_32;
+	if (nrfx_timer_init(&ts_timer, &timer_cfg, timestamp_timer_handler) != NRFX_SUCCESS)
+	{
+		LOG_ERR("Failed to initialize timestamp timer");
+		return -EIO;
+	}
+	if (timestamp_ppi_alloc(&capture_ch) || timestamp_ppi_alloc(&rx_ch) || timestamp_ppi_alloc(&tx_ch))
+		return -ENOMEM;
+	if (nrfx_gppi_group_alloc(&group) != NRFX_SUCCESS)
+	{
+		LOG_ERR("Failed to allocate PPI group");
+		return -ENOMEM;
+	}
+	// ADDRESS is also generated when the radio sends (ACK payloads, sync beacon), the capture
+	// channel is only enabled from RXREADY until the next TXREADY
+	nrfx_gppi_channel_endpoints_setup(capture_ch,
+		nrf_radio_event_address_get(NRF_RADIO, NRF_RADIO_EVENT_ADDRESS),
+		nrfx_timer_capture_task_address_get(&ts_timer, NRF_TIMER_CC_CHANNEL0));
+	nrfx_gppi_channels_include_in_group(BIT(capture_ch), group);
+	nrfx_gppi_channel_endpoints_setup(rx_ch,
+		nrf_radio_event_address_get(NRF_RADIO, NRF_RADIO_EVENT_RXREADY),
+		nrfx_gppi_task_address_get(nrfx_gppi_group_enable_task_get(group)));
+	nrfx_gppi_channel_endpoints_setup(tx_ch,
+		nrf_radio_event_address_get(NRF_RADIO, NRF_RADIO_EVENT_TXREADY),
+		nrfx_gppi_task_address_get(nrfx_gppi_group_disable_task_get(group)));
+	nrfx_gppi_channels_enable(BIT(rx_ch) | BIT(tx_ch));
+	nrfx_timer_enable(&ts_timer);
+	return 0;
+}
+
+SYS_INIT(timestamp_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+uint32_t timestamp_now(void)
+{
+	return nrfx_timer_capture(&ts_timer, NRF_TIMER_CC_CHANNEL1);
+}
+
+// Time of the last radio address match
+// When several packets are read in one event only the last one was captured
+uint32_t timestamp_rx(void)
+{
+	return nrfx_timer_capture_get(&ts_timer, NRF_TIMER_CC_CHANNEL0);
+}
+
+// Called from the forwarding thread once the forward FIFO is empty, so arrival times are not held back
+void timestamp_flush(void)
+{
+	if (!ts_count)
+		return;
+	ts_packet[0] = TELEMETRY_TIMESTAMP;
+	ts_packet[1] = TELEMETRY_ID;
+	ts_packet[2] = ts_count;
+	sys_put_le32(ts_base, &ts_packet[3]);
+	if (hid_tx_write(ts_packet, 0))
+		stats_count(STATS_USB_DROPPED);
+	memset(ts_packet, 0, sizeof(ts_packet));
+	ts_count = 0;
+}
+
+// Called from the forwarding thread after a tracker packet was written to the hid layer
+void timestamp_forward(uint8_t imu_id, uint32_t timestamp)
+{
+	if (ts_count && timestamp - ts_base > UINT16_MAX)
+		timestamp_flush();
+	if (!ts_count)
+		ts_base = timestamp;
+	uint8_t *entry = &ts_packet[7 + ts_count * 3];
+	entry[0] = imu_id;
+	sys_put_le16(timestamp - ts_base, &entry[1]);
+	if (++ts_count == TIMESTAMP_BATCH)
+		timestamp_flush();
+}
+
+#endif
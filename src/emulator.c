@@ -0,0 +1,362 @@
+/* * ROLE: TRACKER EMULATOR (load generator)
+ * Emulates EMU_TRACKERS trackers from one nRF52 with raw RADIO registers, on air
+ * compatible with ESB DPL (2Mbit, 5 byte address, 16 bit CRC) as used by the receiver
+ * 1. Pairing: every tracker pairs on the discovery address, the same burst that
+ *    esb_parse_pair() on the receiver expects (request, sent ack, ack receiver)
+ * 2. Load: interleaved 16 byte packets (type 1) with distinct imu_id at EMU_RATE_HZ
+ *    each, with send jitter, dropped packets (PID still advances, seen as loss) and
+ *    ignored ACKs (retransmit with the same PID, seen as duplicate)
+ * 3. Between packets it listens for the sync beacon and follows channel migrations
+ *    (coexistence and channel scan on the receiver)
+ * Parameters are set with CMake, see CMakeLists.txt
+ */
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/usb/usb_device.h>
+#include <hal/nrf_radio.h>
+#include <string.h>
+
+#include "connection/esb_packet.h"
+
+#ifndef EMU_TRACKERS
+#define EMU_TRACKERS 8
+#endif
+#ifndef EMU_RATE_HZ
+#define EMU_RATE_HZ 200 // per tracker
+#endif
+#ifndef EMU_JITTER_US
+#define EMU_JITTER_US 200 // +/- around the send interval
+#endif
+#ifndef EMU_LOSS_PERMILLE
+#define EMU_LOSS_PERMILLE 0 // packets never sent
+#endif
+#ifndef EMU_DUP_PERMILLE
+#define EMU_DUP_PERMILLE 0 // ACKs ignored, the packet is sent again
+#endif
+#ifndef EMU_PIPES
+#define EMU_PIPES 0 // 1: tracker n sends on pipe n % 8 (CONFIG_ESB_TRACKER_PIPES)
+#endif
+#ifndef EMU_CHANNEL
+#define EMU_CHANNEL 2 // ESB default channel
+#endif
+#ifndef EMU_PROFILE
+#define EMU_PROFILE 0 // enum esb_radio_profile, select the same with "trackers radio" after pairing
+#endif
+#ifndef EMU_TX_POWER
+#define EMU_TX_POWER 0 // dBm (-40, -20, -16, -12, -8, -4, 0, 4), lower to emulate distance
+#endif
+
+#define ACK_TIMEOUT_US 300 // after the end of the packet
+#define MAX_RETRANSMIT 3
+
+// Simulated time only advances while the CPU waits, so polling loops must wait on nrf52_bsim
+#if CONFIG_BOARD_NRF52_BSIM
+#define emu_poll() k_busy_wait(1)
+#else
+#define emu_poll() ((void)0)
+#endif
+
+static const uint8_t discovery_base_addr_0[4] = {0x62, 0x39, 0x8A, 0xF2};
+static const uint8_t discovery_base_addr_1[4] = {0x28, 0xFF, 0x50, 0xB8};
+static const uint8_t discovery_addr_prefix[8] = {0xFE, 0xFF, 0x29, 0x27, 0x09, 0x02, 0xB2, 0xD6};
+
+struct tracker {
+    uint64_t addr; // emulated device address
+    uint8_t id; // imu_id from the receiver, 255 until paired
+    uint8_t pid;
+    uint32_t next; // next send time (us)
+    uint32_t sent, lost, dup, noack;
+};
+
+static struct tracker trackers[EMU_TRACKERS];
+static uint64_t receiver_addr;
+static uint32_t sync_received; // complete sync beacons, the receiver cuts them off at the end of its tx slot
+static bool listening;
+static int channel_next = -1; // announced in the sync beacon
+static uint32_t channel_switch; // time of the switch (us)
+
+// in RAM: length, S1 (pid << 1 | ack requested), payload
+static uint8_t tx_buffer[2 + 32];
+static uint8_t rx_buffer[2 + 32];
+
+static uint32_t rand_state;
+
+#if CONFIG_USB_DEVICE_STACK
+static K_SEM_DEFINE(usb_configured, 0, 1);
+
+static void usb_status(enum usb_dc_status_code status, const uint8_t *param) {
+    if (status == USB_DC_CONFIGURED)
+        k_sem_give(&usb_configured);
+}
+#endif
+
+static uint32_t rand32(void) {
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+static uint32_t now_us(void) {
+    return k_cyc_to_us_floor32(k_cycle_get_32());
+}
+
+static uint8_t bit_reverse(uint8_t b) {
+    b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+    b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+    return (b & 0xAA) >> 1 | (b & 0x55) << 1;
+}
+
+// ESB writes each address byte bit reversed (see esb.c in nrf, addr_conv and bytewise_bit_swap)
+static uint32_t base_conv(const uint8_t *addr) {
+    return (uint32_t)bit_reverse(addr[0]) << 24 | (uint32_t)bit_reverse(addr[1]) << 16 |
+           (uint32_t)bit_reverse(addr[2]) << 8 | bit_reverse(addr[3]);
+}
+
+static uint32_t prefix_conv(const uint8_t *prefix) {
+    return (uint32_t)bit_reverse(prefix[3]) << 24 | (uint32_t)bit_reverse(prefix[2]) << 16 |
+           (uint32_t)bit_reverse(prefix[1]) << 8 | bit_reverse(prefix[0]);
+}
+
+static void radio_set_addr(const uint8_t *base_0, const uint8_t *base_1, const uint8_t *prefix) {
+    NRF_RADIO->BASE0 = base_conv(base_0);
+    NRF_RADIO->BASE1 = base_conv(base_1);
+    NRF_RADIO->PREFIX0 = prefix_conv(&prefix[0]);
+    NRF_RADIO->PREFIX1 = prefix_conv(&prefix[4]);
+}
+
+// Same settings as the radio profiles in esb.c
+static void radio_set_profile(int profile) {
+    switch (profile) {
+    case ESB_PROFILE_LONG_RANGE:
+        NRF_RADIO->MODE = (RADIO_MODE_MODE_Nrf_1Mbit << RADIO_MODE_MODE_Pos);
+        break;
+#ifdef RADIO_MODE_MODE_Ble_2Mbit
+    case ESB_PROFILE_BLE_2M:
+        NRF_RADIO->MODE = (RADIO_MODE_MODE_Ble_2Mbit << RADIO_MODE_MODE_Pos);
+        break;
+#endif
+    default:
+        NRF_RADIO->MODE = (RADIO_MODE_MODE_Nrf_2Mbit << RADIO_MODE_MODE_Pos);
+        break;
+    }
+    NRF_RADIO->MODECNF0 = (profile == ESB_PROFILE_LOW_LATENCY ? RADIO_MODECNF0_RU_Fast : RADIO_MODECNF0_RU_Default) << RADIO_MODECNF0_RU_Pos;
+}
+
+static void radio_init(void) {
+    NRF_RADIO->TASKS_DISABLE = 1;
+    while(NRF_RADIO->EVENTS_DISABLED == 0) emu_poll();
+    NRF_RADIO->FREQUENCY = EMU_CHANNEL;
+    radio_set_profile(ESB_PROFILE_DEFAULT); // pairing
+    NRF_RADIO->TXPOWER = (uint8_t)(int8_t)EMU_TX_POWER; // dBm, must be a level the radio supports
+
+    // PCNF0: DPL, 6 bit length, 3 bit S1 (PID and no_ack)
+    NRF_RADIO->PCNF0 = (6UL << RADIO_PCNF0_LFLEN_Pos) | (3UL << RADIO_PCNF0_S1LEN_Pos);
+
+    // PCNF1: Big Endian, BALEN=4
+    NRF_RADIO->PCNF1 = (32UL << RADIO_PCNF1_MAXLEN_Pos) | (4UL << RADIO_PCNF1_BALEN_Pos) |
+                       (RADIO_PCNF1_ENDIAN_Big << RADIO_PCNF1_ENDIAN_Pos);
+
+    NRF_RADIO->CRCCNF = 2;
+    NRF_RADIO->CRCINIT = 0xFFFF;
+    NRF_RADIO->CRCPOLY = 0x11021;
+}
+
+// Listen for the sync beacon on pipe 0 while no tracker is sending
+static void radio_listen(void) {
+    if (!listening) {
+        NRF_RADIO->RXADDRESSES = 1;
+        NRF_RADIO->PACKETPTR = (uint32_t)rx_buffer;
+        NRF_RADIO->SHORTS = RADIO_SHORTS_READY_START_Msk | RADIO_SHORTS_END_START_Msk;
+        NRF_RADIO->EVENTS_END = 0;
+        NRF_RADIO->TASKS_RXEN = 1;
+        listening = true;
+        return;
+    }
+    if (NRF_RADIO->EVENTS_END == 0)
+        return;
+    NRF_RADIO->EVENTS_END = 0;
+    if (!NRF_RADIO->CRCSTATUS || rx_buffer[0] != ESB_SYNC_LENGTH)
+        return;
+    sync_received++;
+    // byte 12 is the channel (255 for the default), the receiver switches after byte 13 more frames
+    const uint8_t *sync = &rx_buffer[2];
+    int channel = sync[12] == 0xFF ? EMU_CHANNEL : sync[12];
+    if (channel == NRF_RADIO->FREQUENCY) {
+        channel_next = -1;
+        return;
+    }
+    channel_next = channel;
+    channel_switch = now_us() + (sync[13] + 1) * sys_get_be16(&sync[10]); // at the start of the frame after the switch
+}
+
+static void radio_listen_stop(void) {
+    if (!listening)
+        return;
+    listening = false;
+    NRF_RADIO->SHORTS = 0;
+    NRF_RADIO->EVENTS_DISABLED = 0;
+    NRF_RADIO->TASKS_DISABLE = 1;
+    while(NRF_RADIO->EVENTS_DISABLED == 0) emu_poll();
+}
+
+// Send one packet and wait for the ACK, returns the ACK payload length or -1
+static int radio_send(uint8_t pipe, const uint8_t *data, uint8_t length, uint8_t pid) {
+    radio_listen_stop();
+    tx_buffer[0] = length;
+    tx_buffer[1] = (pid & 3) << 1 | 1; // ack requested, the receiver runs with selective_auto_ack
+    memcpy(&tx_buffer[2], data, length);
+
+    NRF_RADIO->TXADDRESS = pipe;
+    NRF_RADIO->RXADDRESSES = 1 << pipe;
+    NRF_RADIO->PACKETPTR = (uint32_t)tx_buffer;
+    NRF_RADIO->EVENTS_DISABLED = 0;
+    NRF_RADIO->EVENTS_END = 0;
+    // TX, then ramp up RX for the ACK right away like ESB does
+    NRF_RADIO->SHORTS = RADIO_SHORTS_READY_START_Msk | RADIO_SHORTS_END_DISABLE_Msk | RADIO_SHORTS_DISABLED_RXEN_Msk;
+    NRF_RADIO->TASKS_TXEN = 1;
+    while(NRF_RADIO->EVENTS_DISABLED == 0) emu_poll();
+    NRF_RADIO->EVENTS_DISABLED = 0;
+    NRF_RADIO->EVENTS_END = 0;
+    NRF_RADIO->PACKETPTR = (uint32_t)rx_buffer; // RX is still ramping up
+    NRF_RADIO->SHORTS = RADIO_SHORTS_READY_START_Msk | RADIO_SHORTS_END_DISABLE_Msk;
+
+    uint32_t start = now_us();
+    while(NRF_RADIO->EVENTS_END == 0) {
+        if (now_us() - start > ACK_TIMEOUT_US + 130) { // + RX ramp up
+            NRF_RADIO->TASKS_DISABLE = 1;
+            while(NRF_RADIO->EVENTS_DISABLED == 0) emu_poll();
+            return -1;
+        }
+        emu_poll();
+    }
+    while(NRF_RADIO->EVENTS_DISABLED == 0) emu_poll();
+    if (!NRF_RADIO->CRCSTATUS)
+        return -1;
+    return rx_buffer[0];
+}
+
+// Pairing burst as sent by tracker firmware, see esb_pair() and esb_parse_pair() on the receiver
+static bool pair_tracker(struct tracker *t) {
+    uint8_t packet[8];
+    memcpy(&packet[2], &t->addr, 6);
+    packet[0] = esb_pair_checksum(&packet[2]);
+    for (uint8_t flag = 0; flag < 3; flag++) {
+        packet[1] = flag;
+        int length = radio_send(0, packet, sizeof(packet), t->pid++);
+        if (flag == 1 && length == 8 && rx_buffer[2] == packet[0]) { // response to the request
+            t->id = rx_buffer[3];
+            memcpy(&receiver_addr, &rx_buffer[4], 6);
+        }
+        k_busy_wait(1000);
+    }
+    return t->id != 255;
+}
+
+static void pair_all(void) {
+    printk("Pairing %d trackers, put the receiver in pairing mode\n", EMU_TRACKERS);
+    radio_set_addr(discovery_base_addr_0, discovery_base_addr_1, discovery_addr_prefix);
+    for (int i = 0; i < EMU_TRACKERS; i++) {
+        while (!pair_tracker(&trackers[i]))
+            k_msleep(10);
+        printk("Tracker %d (%012llX) paired as id %d\n", i, trackers[i].addr, trackers[i].id);
+    }
+    printk("Receiver %012llX, finish pairing on the receiver\n", receiver_addr);
+}
+
+static void make_packet(struct tracker *t, uint8_t *packet) {
+    // slowly changing quaternion (x, y, z, w q15, not normalized) and gravity in accel
+    uint32_t phase = (now_us() / 1000 + t->id * 97) & 0xFFF;
+    int16_t x = (int16_t)((int32_t)phase * 16 - 32768) / 4;
+    int16_t quat[4] = {x, 0, 0, 31000};
+    int16_t accel[3] = {0, 0, 128 * 8};
+    packet[0] = 1;
+    packet[1] = t->id;
+    memcpy(&packet[2], quat, 8);
+    memcpy(&packet[10], accel, 6);
+}
+
+static void send_tracker(struct tracker *t) {
+    uint8_t packet[16];
+    uint8_t pipe = EMU_PIPES ? esb_tracker_pipe(t->id) : 0;
+    make_packet(t, packet);
+    t->pid++;
+    if (rand32() % 1000 < EMU_LOSS_PERMILLE) {
+        t->lost++;
+        return;
+    }
+    for (int retry = 0; retry <= MAX_RETRANSMIT; retry++) {
+        t->sent++;
+        if (radio_send(pipe, packet, sizeof(packet), t->pid) < 0) {
+            t->noack++;
+            continue;
+        }
+        if (rand32() % 1000 < EMU_DUP_PERMILLE) { // ACK ignored, retransmit
+            t->dup++;
+            continue;
+        }
+        break;
+    }
+}
+
+void main(void) {
+#if CONFIG_USB_DEVICE_STACK
+    usb_enable(usb_status);
+#endif
+    radio_init(); // while the host enumerates
+#if CONFIG_USB_DEVICE_STACK
+    k_sem_take(&usb_configured, K_SECONDS(3));
+#endif
+    printk("\n=== TRACKER EMULATOR START (%d trackers, %d Hz, profile %d, %d dBm) ===\n", EMU_TRACKERS, EMU_RATE_HZ, EMU_PROFILE, EMU_TX_POWER);
+
+    uint64_t device_addr = ((uint64_t)NRF_FICR->DEVICEADDR[1] << 32 | NRF_FICR->DEVICEADDR[0]) & 0xFFFFFFFFFFFF;
+    rand_state = (uint32_t)device_addr | 1;
+    for (int i = 0; i < EMU_TRACKERS; i++) {
+        trackers[i].addr = (device_addr + i + 1) & 0xFFFFFFFFFFFF; // distinct address per tracker
+        trackers[i].id = 255;
+    }
+
+    pair_all();
+
+    uint8_t base_0[4], base_1[4], prefix[8];
+    esb_addr_from_device(receiver_addr, base_0, base_1, prefix);
+    radio_set_addr(base_0, base_1, prefix);
+    radio_set_profile(EMU_PROFILE);
+
+    uint32_t interval = 1000000 / EMU_RATE_HZ;
+    uint32_t start = now_us();
+    for (int i = 0; i < EMU_TRACKERS; i++)
+        trackers[i].next = start + interval * i / EMU_TRACKERS; // interleaved
+    uint32_t report = start + 1000000;
+
+    while(1) {
+        uint32_t now = now_us();
+        for (int i = 0; i < EMU_TRACKERS; i++) {
+            struct tracker *t = &trackers[i];
+            if ((int32_t)(now - t->next) < 0)
+                continue;
+            send_tracker(t);
+            int32_t jitter = EMU_JITTER_US ? (int32_t)(rand32() % (2 * EMU_JITTER_US + 1)) - EMU_JITTER_US : 0;
+            t->next += interval + jitter;
+        }
+        if ((int32_t)(now - report) >= 0) {
+            report += 1000000;
+            for (int i = 0; i < EMU_TRACKERS; i++) {
+                struct tracker *t = &trackers[i];
+                printk("id %3d sent %6u lost %5u dup %5u noack %5u\n", t->id, t->sent, t->lost, t->dup, t->noack);
+            }
+            printk("sync %u\n", sync_received);
+            sync_received = 0;
+        }
+        if (channel_next >= 0 && (int32_t)(now - channel_switch) >= 0) {
+            radio_listen_stop(); // applied with the next ramp-up
+            NRF_RADIO->FREQUENCY = channel_next;
+            printk("Channel %d\n", channel_next);
+            channel_next = -1;
+        }
+        radio_listen();
+        k_yield();
+        emu_poll();
+    }
+}
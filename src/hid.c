@@ -0,0 +1,123 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+#include "system/system.h"
+
+#include <zephyr/usb/usb_device.h>
+#include <zephyr/usb/class/usb_hid.h>
+
+#include "connection/esb_packet.h"
+#include "connection/stats.h"
+#include "connection/hid_tx.h"
+#include "hid.h"
+
+LOG_MODULE_REGISTER(hid, LOG_LEVEL_INF);
+
+#if CONFIG_USB_DEVICE_HID
+
+// Vendor defined input report of up to HID_TX_REPORT_PACKETS packets
+static const uint8_t hid_report_desc[] = {
+	0x06, 0x00, 0xFF, // Usage Page (Vendor Defined 0xFF00)
+	0x09, 0x01, // Usage (0x01)
+	0xA1, 0x01, // Collection (Application)
+	0x15, 0x00, // Logical Minimum (0)
+	0x26, 0xFF, 0x00, // Logical Maximum (255)
+	0x75, 0x08, // Report Size (8)
+	0x95, HID_TX_PACKET_SIZE * HID_TX_REPORT_PACKETS, // Report Count
+	0x09, 0x01, // Usage (0x01)
+	0x81, 0x02, // Input (Data, Variable, Absolute)
+	0xC0, // End Collection
+};
+
+static const struct device *hdev;
+static K_MUTEX_DEFINE(hid_write_lock); // forwarding, prediction and telemetry threads write packets
+
+#if CONFIG_HID_TX
+static const struct hid_ops hid_ops = {
+	.int_in_ready = hid_tx_in_ready, // the next report is written once the previous one went out
+};
+#define HID_OPS (&hid_ops)
+#else
+#define HID_OPS NULL // hid_write_packet_n writes each packet right away
+#endif
+
+static void hid_usb_status(enum usb_dc_status_code status, const uint8_t *param)
+{
+	switch (status)
+	{
+	case USB_DC_SOF:
+		hid_tx_sof();
+		return;
+	case USB_DC_CONFIGURED:
+		set_status(SYS_STATUS_USB_CONNECTED, true);
+		break;
+	case USB_DC_DISCONNECTED:
+		set_status(SYS_STATUS_USB_CONNECTED, false);
+		break;
+	default:
+		break;
+	}
+	hid_tx_usb_status(status);
+}
+
+int hid_init(void)
+{
+	hdev = device_get_binding("HID_0");
+	if (!hdev)
+	{
+		LOG_ERR("HID device not found");
+		return -ENODEV;
+	}
+	usb_hid_register_device(hdev, hid_report_desc, sizeof(hid_report_desc), HID_OPS);
+	int err = usb_hid_init(hdev);
+	if (!err)
+		err = usb_enable(hid_usb_status);
+	if (err)
+		LOG_ERR("Failed to enable USB: %d", err);
+	return err;
+}
+
+void hid_write_packet_n(uint8_t *data, uint8_t rssi)
+{
+	uint8_t report[HID_TX_PACKET_SIZE];
+	memcpy(report, data, sizeof(report));
+	if (data[0] != 1 && data[0] != 4 && data[0] < ESB_PACKET_TYPE_RESERVED) // packet 1 and 4 are full precision, no room for rssi
+		report[15] = rssi;
+	k_mutex_lock(&hid_write_lock, K_FOREVER);
+	int err = hid_int_ep_write(hdev, report, sizeof(report), NULL); // copied to the endpoint buffer
+	k_mutex_unlock(&hid_write_lock);
+	stats_count(err ? STATS_USB_DROPPED : STATS_USB_REPORTS);
+}
+
+#else // no USB, e.g. nrf52_bsim, packets end at the HID boundary
+
+int hid_init(void)
+{
+	return 0;
+}
+
+void hid_write_packet_n(uint8_t *data, uint8_t rssi)
+{
+}
+
+#endif
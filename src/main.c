@@ -11,10 +11,15 @@
 
 static uint8_t rx_buffer[64];
 
+static K_SEM_DEFINE(usb_configured, 0, 1);
+
+static void usb_status(enum usb_dc_status_code status, const uint8_t *param) {
+    if (status == USB_DC_CONFIGURED)
+        k_sem_give(&usb_configured);
+}
+
 void main(void) {
-    usb_enable(NULL);
-    k_sleep(K_SECONDS(3));
-    printk("\n=== LISTENER START (Looking for ACK) ===\n");
+    usb_enable(usb_status);
 
     // Init Radio (RX Config)
     NRF_RADIO->TASKS_DISABLE = 1;
@@ -40,7 +45,10 @@ void main(void) {
     NRF_RADIO->SHORTS = RADIO_SHORTS_READY_START_Msk | RADIO_SHORTS_END_START_Msk; // 持續接收
     NRF_RADIO->TASKS_RXEN = 1;
 
-    printk("Listening on 2401 MHz...\n");
+    // 收音機已在接收, 等 USB 列舉完成再印 (最多 3 秒)
+    k_sem_take(&usb_configured, K_SECONDS(3));
+    printk("\n=== LISTENER START (Looking for ACK) ===\n");
+    printk("Listening on 2401 MHz... (USB ready after %u ms)\n", k_uptime_get_32());
 
     while(1) {
         if (NRF_RADIO->EVENTS_END) {
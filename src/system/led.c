@@ -1,5 +1,4 @@
 #include "globals.h"
-#include "util.h"
 
 #include <math.h>
 #include <zephyr/drivers/gpio.h>
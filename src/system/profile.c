@@ -0,0 +1,155 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+#include "profile.h"
+
+#if CONFIG_ISR_PROFILE
+
+static struct profile_data profile[PROFILE_POINT_COUNT];
+
+static const char *const profile_names[PROFILE_POINT_COUNT] = {
+	"esb event",
+	"esb pair",
+	"esb tracker",
+	"timer",
+	"timer compare0",
+	"timer compare1",
+	"timer compare2",
+	"predict",
+	"forward",
+};
+
+LOG_MODULE_REGISTER(profile, LOG_LEVEL_INF);
+
+static int profile_init(void)
+{
+#if CONFIG_CORTEX_M_DWT
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+	profile_reset();
+	return 0;
+}
+
+SYS_INIT(profile_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+RX_HOT void profile_end(enum profile_point point, uint32_t start)
+{
+	uint32_t cycles = profile_start() - start;
+	struct profile_data *data = &profile[point];
+	data->count++;
+	data->total += cycles;
+	if (cycles < data->min)
+		data->min = cycles;
+	if (cycles > data->max)
+		data->max = cycles;
+	int bin = cycles ? 32 - __builtin_clz(cycles) : 0;
+	if (bin >= PROFILE_BINS)
+		bin = PROFILE_BINS - 1;
+	data->hist[bin]++;
+}
+
+uint32_t profile_cycles_per_us(void)
+{
+#if CONFIG_CORTEX_M_DWT
+	return SystemCoreClock / 1000000;
+#else
+	uint32_t cycles = sys_clock_hw_cycles_per_sec() / 1000000;
+	return cycles ? cycles : 1;
+#endif
+}
+
+void profile_get(enum profile_point point, struct profile_data *out)
+{
+	unsigned int key = irq_lock(); // written from ISRs
+	memcpy(out, &profile[point], sizeof(*out));
+	irq_unlock(key);
+}
+
+void profile_reset(void)
+{
+	unsigned int key = irq_lock();
+	memset(profile, 0, sizeof(profile));
+	for (int i = 0; i < PROFILE_POINT_COUNT; i++)
+		profile[i].min = UINT32_MAX;
+	irq_unlock(key);
+}
+
+#if CONFIG_SHELL
+static int cmd_profile_show(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t cycles_per_us = profile_cycles_per_us();
+	struct profile_data data;
+	shell_print(sh, "%-16s %8s %8s %8s %8s (cycles, %u/us)", "point", "count", "min", "mean", "max", cycles_per_us);
+	for (int i = 0; i < PROFILE_POINT_COUNT; i++)
+	{
+		profile_get(i, &data);
+		if (!data.count)
+		{
+			shell_print(sh, "%-16s %8u", profile_names[i], 0);
+			continue;
+		}
+		shell_print(sh, "%-16s %8u %8u %8u %8u", profile_names[i], data.count, data.min, (uint32_t)(data.total / data.count), data.max);
+	}
+	return 0;
+}
+
+static int cmd_profile_hist(const struct shell *sh, size_t argc, char **argv)
+{
+	struct profile_data data;
+	for (int i = 0; i < PROFILE_POINT_COUNT; i++)
+	{
+		profile_get(i, &data);
+		if (!data.count)
+			continue;
+		shell_print(sh, "%s:", profile_names[i]);
+		for (int j = 0; j < PROFILE_BINS; j++)
+			if (data.hist[j])
+				shell_print(sh, "  < %7u cycles: %u", 1 << j, data.hist[j]);
+	}
+	return 0;
+}
+
+static int cmd_profile_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	profile_reset();
+	shell_print(sh, "Profile reset");
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_profile,
+	SHELL_CMD(show, NULL, "Show ISR timing", cmd_profile_show),
+	SHELL_CMD(hist, NULL, "Show ISR timing histograms", cmd_profile_hist),
+	SHELL_CMD(reset, NULL, "Reset ISR timing", cmd_profile_reset),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(profile, &sub_profile, "ISR profiling", NULL);
+#endif
+
+#endif
@@ -0,0 +1,85 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_SYSTEM_PROFILE
+#define SLIMENRF_SYSTEM_PROFILE
+
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/linker/section_tags.h>
+#if CONFIG_CORTEX_M_DWT
+#include <cmsis_core.h>
+#endif
+
+// Radio hot path, placed in RAM with CONFIG_RX_RAMFUNC so flash wait states and NVS writes do not stall it
+#if CONFIG_RX_RAMFUNC
+#define RX_HOT __ramfunc
+#else
+#define RX_HOT
+#endif
+
+enum profile_point {
+	PROFILE_ESB_EVENT, // event_handler
+	PROFILE_ESB_PAIR, // event_handler, pairing packet
+	PROFILE_ESB_TRACKER, // event_handler, tracker packet
+	PROFILE_TIMER, // timer_handler
+	PROFILE_TIMER_COMPARE0, // timer_handler, start tx
+	PROFILE_TIMER_COMPARE1, // timer_handler, switch to tx
+	PROFILE_TIMER_COMPARE2, // timer_handler, switch to rx
+	PROFILE_PREDICT, // predict_update or one predicted sample
+	PROFILE_FORWARD, // forward_packet, copy into the HID report
+	PROFILE_POINT_COUNT
+};
+
+// Histogram, bin n counts durations in [2^(n-1), 2^n) cycles
+#define PROFILE_BINS 20
+
+struct profile_data {
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+	uint32_t hist[PROFILE_BINS];
+};
+
+#if CONFIG_ISR_PROFILE
+static inline uint32_t profile_start(void)
+{
+#if CONFIG_CORTEX_M_DWT
+	return DWT->CYCCNT;
+#else
+	return k_cycle_get_32();
+#endif
+}
+
+void profile_end(enum profile_point point, uint32_t start);
+
+uint32_t profile_cycles_per_us(void);
+void profile_get(enum profile_point point, struct profile_data *out);
+void profile_reset(void);
+#else
+#define profile_start() 0
+#define profile_end(point, start) ((void)(start))
+#endif
+
+#endif
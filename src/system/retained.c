@@ -0,0 +1,66 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/crc.h>
+
+#include "retained.h"
+
+static __noinit struct retained_data retained_data;
+struct retained_data *const retained = &retained_data;
+
+static bool valid_at_boot = false;
+
+static uint32_t retained_crc(void) {
+	return crc32_ieee((const uint8_t *)&retained_data, offsetof(struct retained_data, crc));
+}
+
+static int retained_init(void) {
+	valid_at_boot = retained_data.crc == retained_crc();
+	if (!valid_at_boot) {
+		memset(&retained_data, 0, sizeof(retained_data)); // cold boot, filled from NVS
+	}
+	return 0;
+}
+
+SYS_INIT(retained_init, PRE_KERNEL_1, 0);
+
+bool retained_valid(void) {
+	return valid_at_boot;
+}
+
+void retained_update(void) {
+	unsigned int key = irq_lock();
+	if (retained_data.loaded == RETAINED_ALL) { // stays invalid until every part is copied from NVS
+		retained_data.crc = retained_crc();
+	}
+	irq_unlock(key);
+}
+
+void retained_loaded(uint8_t part) {
+	unsigned int key = irq_lock();
+	retained_data.loaded |= part;
+	irq_unlock(key);
+	retained_update();
+}
@@ -0,0 +1,52 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_SYSTEM_RETAINED
+#define SLIMENRF_SYSTEM_RETAINED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Copy of the stored data in RAM that is not cleared on reset
+// After a warm boot (watchdog, software reset, DFU) it is used instead of reading NVS
+struct retained_data {
+	uint8_t loaded; // parts copied from NVS after a cold boot
+	uint8_t reboot_counter;
+	__typeof__(stored_trackers) stored_trackers;
+	uint64_t stored_tracker_addr[MAX_TRACKERS];
+	uint8_t radio_profile; // as STORED_RADIO_PROFILE
+	uint8_t rf_channel; // as STORED_RF_CHANNEL
+	uint8_t tracker_weight[MAX_TRACKERS];
+	uint32_t crc;
+};
+
+#define RETAINED_TRACKERS (1 << 0)
+#define RETAINED_WEIGHTS (1 << 1)
+#define RETAINED_ALL (RETAINED_TRACKERS | RETAINED_WEIGHTS)
+
+extern struct retained_data *const retained;
+
+bool retained_valid(void); // retained data was valid at boot
+void retained_update(void); // after changing retained data
+void retained_loaded(uint8_t part); // part was copied from NVS, retained data is valid once all parts are
+
+#endif
@@ -3,12 +3,14 @@
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/drivers/pwm.h>
 #include <zephyr/sys/reboot.h>
+#include <zephyr/drivers/clock_control/nrf_clock_control.h>
 #include <zephyr/drivers/flash.h>
 #include <zephyr/storage/flash_map.h>
 #include <zephyr/fs/nvs.h>
 #include <hal/nrf_gpio.h>
 
 #include "system.h"
+#include "retained.h"
 
 static struct nvs_fs fs;
 
@@ -19,11 +21,38 @@ static struct nvs_fs fs;
 LOG_MODULE_REGISTER(system, LOG_LEVEL_INF);
 
 static bool nvs_init = false;
+static K_MUTEX_DEFINE(nvs_init_lock);
 
-static int sys_nvs_init(void) {
-	if (nvs_init) {
-		return 0;
+static uint32_t boot_phase_us[SYS_BOOT_PHASE_COUNT];
+
+// May be called from interrupts, only the first packet logs
+void sys_boot_phase(enum sys_boot_phase phase) {
+	if (boot_phase_us[phase]) {
+		return;
+	}
+	boot_phase_us[phase] = MAX(k_cyc_to_us_floor32(k_cycle_get_32()), 1);
+	if (phase != SYS_BOOT_FIRST_PACKET) {
+		return;
 	}
+	static const char *const names[] = {"hfclk", "nvs", "trackers", "usb", "rx", "first packet"};
+	BUILD_ASSERT(ARRAY_SIZE(names) == SYS_BOOT_PHASE_COUNT);
+	char buf[128];
+	int len = 0;
+	for (int i = 0; i < SYS_BOOT_PHASE_COUNT; i++) {
+		if (boot_phase_us[i]) {
+			len += snprintk(&buf[len], sizeof(buf) - len, " %s %u.%03u", names[i], boot_phase_us[i] / 1000, boot_phase_us[i] % 1000);
+		} else {
+			len += snprintk(&buf[len], sizeof(buf) - len, " %s -", names[i]);
+		}
+		if (len >= sizeof(buf)) {
+			break;
+		}
+	}
+	LOG_INF("%s boot (ms):%s", retained_valid() ? "Warm" : "Cold", buf);
+}
+
+// Mounted on first use, after a warm boot the stored data is read from retained RAM instead
+static int sys_nvs_mount(void) {
 	struct flash_pages_info info;
 	fs.flash_device = NVS_PARTITION_DEVICE;
 	fs.offset = NVS_PARTITION_OFFSET;  // starting at NVS_PARTITION_OFFSET
@@ -50,24 +79,38 @@ static int sys_nvs_init(void) {
 		return 1;
 	}
 	nvs_init = true;
+	sys_boot_phase(SYS_BOOT_NVS);
 	return 0;
 }
 
-SYS_INIT(sys_nvs_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+static int sys_nvs_init(void) {
+	k_mutex_lock(&nvs_init_lock, K_FOREVER);
+	int err = nvs_init ? 0 : sys_nvs_mount();
+	k_mutex_unlock(&nvs_init_lock);
+	return err;
+}
 
-// TODO: switch back to retained?
 uint8_t reboot_counter_read(void) {
+	if (retained_valid()) {
+		return retained->reboot_counter;
+	}
 	uint8_t reboot_counter;
-	nvs_read(&fs, RBT_CNT_ID, &reboot_counter, sizeof(reboot_counter));
+	sys_read(RBT_CNT_ID, &reboot_counter, sizeof(reboot_counter));
+	retained->reboot_counter = reboot_counter;
+	retained_update();
 	return reboot_counter;
 }
 
 void reboot_counter_write(uint8_t reboot_counter) {
-	nvs_write(&fs, RBT_CNT_ID, &reboot_counter, sizeof(reboot_counter));
+	sys_write(RBT_CNT_ID, &retained->reboot_counter, &reboot_counter, sizeof(reboot_counter));
 }
 
-// retained not implemented
+// retained_ptr is the copy of the data in retained RAM, or NULL
 void sys_write(uint16_t id, void* retained_ptr, const void* data, size_t len) {
+	if (retained_ptr) {
+		memcpy(retained_ptr, data, len);
+		retained_update();
+	}
 	sys_nvs_init();
 	int err = nvs_write(&fs, id, data, len);
 	if (err < 0)
@@ -96,3 +139,78 @@ void sys_read(uint16_t id, void* data, size_t len) {
 		return;
 	}
 }
+
+// Use device address as unique identifier (although it is not actually guaranteed, see datasheet)
+uint64_t sys_device_addr(void) {
+	uint64_t addr;
+	memcpy(&addr, (const void *)NRF_FICR->DEVICEADDR, sizeof(addr));
+	return addr & 0xFFFFFFFFFFFF;
+}
+
+static struct onoff_client clk_cli;
+static bool clk_requested = false;
+
+// Request the HF clock without waiting, so the crystal starts up while other init runs
+int clocks_request(void) {
+	int err;
+	struct onoff_manager *clk_mgr;
+
+	if (clk_requested) {
+		return 0;
+	}
+
+	clk_mgr = z_nrf_clock_control_get_onoff(CLOCK_CONTROL_NRF_SUBSYS_HF);
+	if (!clk_mgr) {
+		LOG_ERR("Unable to get the Clock manager");
+		return -ENXIO;
+	}
+
+	sys_notify_init_spinwait(&clk_cli.notify);
+
+	err = onoff_request(clk_mgr, &clk_cli);
+	if (err < 0) {
+		LOG_ERR("Clock request failed: %d", err);
+		return err;
+	}
+	clk_requested = true;
+	return 0;
+}
+
+#define CLOCKS_WAIT_TIMEOUT_MS 10
+
+int clocks_wait(void) {
+	int err;
+	int res;
+	int64_t timeout = k_uptime_get() + CLOCKS_WAIT_TIMEOUT_MS;
+
+	if (!clk_requested) {
+		return -EINVAL;
+	}
+
+	do {
+		err = sys_notify_fetch_result(&clk_cli.notify, &res);
+		if (!err && res) {
+			LOG_ERR("Clock could not be started: %d", res);
+			return res;
+		}
+		if (err && k_uptime_get() > timeout) {
+			LOG_WRN("Unable to fetch Clock request result: %d", err);
+			return err;
+		}
+		if (err) {
+			k_yield();
+		}
+	} while (err);
+
+	LOG_DBG("HF clock started");
+	sys_boot_phase(SYS_BOOT_HFCLK);
+	return 0;
+}
+
+int clocks_start(void) {
+	int err = clocks_request();
+	if (err) {
+		return err;
+	}
+	return clocks_wait();
+}
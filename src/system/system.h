@@ -11,6 +11,9 @@
 #define STORED_ADDR_0 3
 // 0-15 -> id 3-18
 // 0-255 -> id 3-258
+#define STORED_TRACKER_WEIGHT 259 // forwarding weight of all trackers, MAX_TRACKERS bytes
+#define STORED_RADIO_PROFILE 260 // profile + 1, 0 for CONFIG_ESB_RADIO_PROFILE
+#define STORED_RF_CHANNEL 261 // channel + 1, 0 for the default channel
 
 uint8_t reboot_counter_read(void);
 void reboot_counter_write(uint8_t reboot_counter);
@@ -18,4 +21,23 @@ void reboot_counter_write(uint8_t reboot_counter);
 void sys_write(uint16_t id, void* ptr, const void* data, size_t len);
 void sys_read(uint16_t id, void* data, size_t len);
 
+uint64_t sys_device_addr(void);
+
+int clocks_request(void);
+int clocks_wait(void);
+int clocks_start(void); // request and wait
+
+// Boot phases, each is recorded the first time it completes and all of them are logged with the first packet
+enum sys_boot_phase {
+	SYS_BOOT_HFCLK, // HF clock running
+	SYS_BOOT_NVS, // NVS mounted, not needed on warm boot
+	SYS_BOOT_TRACKERS, // tracker table loaded
+	SYS_BOOT_USB, // USB configured by the host
+	SYS_BOOT_RX, // ESB receiving
+	SYS_BOOT_FIRST_PACKET, // first tracker packet forwarded to the host
+	SYS_BOOT_PHASE_COUNT
+};
+
+void sys_boot_phase(enum sys_boot_phase phase);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,144 @@
+#!/usr/bin/env bash
+# N-tracker throughput benchmark on BabbleSim (nrf52_bsim)
+#
+# Builds the receiver and the tracker emulator for nrf52_bsim, runs one receiver against
+# N emulator devices (one tracker each, so their packets collide on air like real trackers)
+# and prints the receiver statistics of one interval after pairing: packets/s at each
+# stage, drops per stage and latency percentiles. sync/s is the number of complete sync
+# beacons the first emulator received in its last second, it listens while it is not sending.
+#
+# With RECEIVERS > 1 every receiver gets N trackers of its own and all of them share the
+# air, like several receivers in one room. Trackers are NEAR_DB from their receiver and
+# FAR_DB from the others, so they pair with their own receiver. Rates and drops are summed
+# over the receivers (aggregate throughput), latency is the worst receiver. The receivers
+# run in coexistence mode (CONFIG_ESB_COEXIST), the emulators follow their channel.
+#
+# irq/s counts ESB RX interrupts (stats "irq"), irq/rcv is the same per receiver. Compare a
+# crowded run with PIPES=0 and PIPES=1: with tracker pipes the radio drops packets for other
+# receivers without an interrupt, without them they show up as filter drops after one.
+#
+# PROFILES runs every radio profile (receiver and emulators), ATTENUATIONS adds path loss on
+# top of NEAR_DB to emulate distance. att_dB is the loss between a tracker and its receiver,
+# compare hid/s and lost per profile as it grows.
+#
+# Needs a west workspace with BabbleSim built (BSIM_OUT_PATH, BSIM_COMPONENTS_PATH), see
+# https://docs.zephyrproject.org/latest/boards/native/nrf_bsim/doc/nrf52_bsim.html
+#
+# usage: tests/bsim/trackers/run.sh [tracker counts...]     (default 1 2 4 8 16 24 32)
+#        RECEIVERS=8 tests/bsim/trackers/run.sh 10           (8 receivers x 10 trackers)
+#        PROFILES="0 1 2 3" ATTENUATIONS="0 20 30 35 40" tests/bsim/trackers/run.sh 8
+# environment: RATE_HZ     packet rate per tracker (default 200)
+#              SECONDS_    measured interval, also the pairing warmup (default 10)
+#              JITTER_US   send jitter (default 200)
+#              EXTRA_CONF  additional receiver Kconfig fragment, to compare settings
+#              RECEIVERS   receivers sharing the air (default 1)
+#              NEAR_DB     attenuation between a tracker and its receiver (default 60)
+#              FAR_DB      attenuation to the other receivers (default 80)
+#              PIPES       1: trackers on ESB pipes (CONFIG_ESB_TRACKER_PIPES, default 0)
+#              PROFILES    radio profiles, enum esb_radio_profile (default 0)
+#              ATTENUATIONS  extra attenuation on all paths (dB, default 0)
+set -e
+
+: "${BSIM_OUT_PATH:?BSIM_OUT_PATH is not set}"
+RATE_HZ=${RATE_HZ:-200}
+SECONDS_=${SECONDS_:-10}
+JITTER_US=${JITTER_US:-200}
+RECEIVERS=${RECEIVERS:-1}
+NEAR_DB=${NEAR_DB:-60}
+FAR_DB=${FAR_DB:-80}
+PIPES=${PIPES:-0}
+PROFILES=${PROFILES:-0}
+ATTENUATIONS=${ATTENUATIONS:-0}
+COUNTS=${*:-1 2 4 8 16 24 32}
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+APP=$(cd "$HERE/../../.." && pwd)
+BUILD=${BUILD:-$APP/build_bsim}
+OVERLAY="$HERE/nrf52_bsim.overlay"
+RX_CONF="$APP/receiver.conf;$HERE/bsim.conf;$HERE/receiver.conf${EXTRA_CONF:+;$EXTRA_CONF}"
+COEXIST=n
+[ "$RECEIVERS" -gt 1 ] && COEXIST=y
+TRACKER_PIPES=n
+[ "$PIPES" -eq 1 ] && TRACKER_PIPES=y
+
+# receiver and emulator built with the radio profile
+build() {
+	local profile=$1
+	west build -p -b nrf52_bsim -d "$BUILD/receiver_$profile" "$APP" -- -DRECEIVER=ON \
+		-DEXTRA_CONF_FILE="$RX_CONF" -DDTC_OVERLAY_FILE="$OVERLAY" \
+		-DCONFIG_RX_STATS_INTERVAL="$SECONDS_" -DCONFIG_ESB_COEXIST="$COEXIST" \
+		-DCONFIG_ESB_TRACKER_PIPES="$TRACKER_PIPES" -DCONFIG_ESB_RADIO_PROFILE="$profile"
+	west build -p -b nrf52_bsim -d "$BUILD/emulator_$profile" "$APP" -- -DTRACKER_EMULATOR=ON \
+		-DEMU_TRACKERS=1 -DEMU_RATE_HZ="$RATE_HZ" -DEMU_JITTER_US="$JITTER_US" -DEMU_PIPES="$PIPES" \
+		-DEMU_PROFILE="$profile" -DEXTRA_CONF_FILE="$HERE/bsim.conf" -DDTC_OVERLAY_FILE="$OVERLAY"
+}
+
+# Attenuation matrix for the NtNcable channel: "tx rx : dB", other paths use the default
+# receivers are devices 0 to RECEIVERS - 1, the trackers of receiver r follow in blocks of n
+attenuations() {
+	local n=$1 r e
+	for e in $(seq "$RECEIVERS" $((RECEIVERS + RECEIVERS * n - 1))); do
+		for r in $(seq 0 $((RECEIVERS - 1))); do
+			local db=$FAR_DB
+			[ $(((e - RECEIVERS) / n)) -eq "$r" ] && db=$NEAR_DB
+			echo "$e $r : $db"
+			echo "$r $e : $db"
+		done
+	done
+}
+
+for profile in $PROFILES; do
+	build "$profile"
+done
+
+# one simulation, prints a table row
+run() {
+	local profile=$1 extra=$2 n=$3 r d
+	local sim_id="slimenrf_trackers_${profile}_${extra}_${n}_$$"
+	local devices=$((RECEIVERS * (n + 1)))
+	# stats are logged every SECONDS_, the first interval covers pairing, the second is measured
+	local sim_us=$((SECONDS_ * 2000000 + 500000))
+	local logs="$BUILD/p${profile}_at${extra}_$n"
+	for r in $(seq 0 $((RECEIVERS - 1))); do
+		"$BUILD/receiver_$profile/zephyr/zephyr.exe" -s="$sim_id" -d="$r" -rs=$((1 + r)) > "${logs}_receiver_$r.log" 2>&1 &
+	done
+	for d in $(seq "$RECEIVERS" $((devices - 1))); do
+		local log=/dev/null
+		[ "$d" -eq "$RECEIVERS" ] && log="${logs}_emulator.log"
+		"$BUILD/emulator_$profile/zephyr/zephyr.exe" -s="$sim_id" -d="$d" -rs=$((100 + d)) > "$log" 2>&1 &
+	done
+	local channel=(-argschannel -at="$NEAR_DB" -atextra="$extra")
+	if [ "$RECEIVERS" -gt 1 ]; then
+		attenuations "$n" > "${logs}_attenuation.txt"
+		channel+=(-file="${logs}_attenuation.txt")
+	fi
+	./bs_2G4_phy_v1 -s="$sim_id" -D="$devices" -sim_length="$sim_us" "${channel[@]}" -argsmain > /dev/null 2>&1
+	wait
+	# irq rx hid usb | radio filter reserved duplicate usb | lost coalesced sof predicted slips | p50 p90 p99
+	# summed over the receivers, the worst percentiles
+	local line=$(for r in $(seq 0 $((RECEIVERS - 1))); do
+		grep "stats: irq" "${logs}_receiver_$r.log" | sed -n 2p | sed 's/.*stats: //; s/p[0-9][0-9] //g; s/[^0-9]\+/ /g'
+	done | awk -v receivers="$RECEIVERS" 'NF { for (i = 1; i <= NF; i++) s[i] = i > 14 ? (s[i] > $i ? s[i] : $i) : s[i] + $i; rows++; n = NF }
+		END { if (rows == receivers) for (i = 1; i <= n; i++) printf "%d ", s[i] }')
+	if [ -z "$line" ]; then
+		printf "%7s %6s %8s %9s  no packets received by every receiver, see %s\n" "$profile" $((NEAR_DB + extra)) "$n" \
+			$((RECEIVERS * n * RATE_HZ)) "${logs}_receiver_*.log"
+		return
+	fi
+	local sync=$(grep "^sync " "${logs}_emulator.log" | tail -n 1 | cut -d' ' -f2)
+	set -- $line
+	printf "%7s %6s %8s %9s %8s %8s %8s %8s %7s %7s %7s %7s %7s %8s %8s %8s %7s\n" "$profile" $((NEAR_DB + extra)) "$n" \
+		$((RECEIVERS * n * RATE_HZ)) "$1" $(($1 / RECEIVERS)) "$2" "$3" "$5" "$6" "$8" "$9" "${10}" "${15}" "${16}" "${17}" "${sync:--}"
+}
+
+cd "$BSIM_OUT_PATH/bin"
+[ "$RECEIVERS" -gt 1 ] && echo "$RECEIVERS receivers, trackers per receiver, totals over all receivers"
+printf "%7s %6s %8s %9s %8s %8s %8s %8s %7s %7s %7s %7s %7s %8s %8s %8s %7s\n" profile att_dB trackers offered/s irq/s irq/rcv \
+	rx/s hid/s radio filter dup usb lost p50_us p90_us p99_us sync/s
+for profile in $PROFILES; do
+	for extra in $ATTENUATIONS; do
+		for n in $COUNTS; do
+			run "$profile" "$extra" "$n"
+		done
+	done
+done
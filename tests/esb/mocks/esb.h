@@ -0,0 +1,108 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_MOCK_ESB
+#define SLIMENRF_MOCK_ESB
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+// Subset of the NCS ESB driver API used by src/connection, see mocks.c
+
+#define CONFIG_ESB_MAX_PAYLOAD_LENGTH 32
+
+enum esb_mode {
+	ESB_MODE_PTX,
+	ESB_MODE_PRX,
+};
+
+enum esb_bitrate {
+	ESB_BITRATE_1MBPS,
+	ESB_BITRATE_2MBPS,
+	ESB_BITRATE_2MBPS_BLE,
+};
+
+enum esb_crc {
+	ESB_CRC_16BIT,
+};
+
+enum esb_tx_mode {
+	ESB_TXMODE_AUTO,
+	ESB_TXMODE_MANUAL,
+};
+
+enum esb_evt_id {
+	ESB_EVENT_TX_SUCCESS,
+	ESB_EVENT_TX_FAILED,
+	ESB_EVENT_RX_RECEIVED,
+};
+
+struct esb_payload {
+	uint8_t length;
+	uint8_t pipe;
+	int8_t rssi;
+	uint8_t noack;
+	uint8_t pid;
+	uint8_t data[CONFIG_ESB_MAX_PAYLOAD_LENGTH];
+};
+
+struct esb_evt {
+	enum esb_evt_id evt_id;
+	uint32_t tx_attempts;
+};
+
+typedef void (*esb_event_handler)(struct esb_evt const *event);
+
+struct esb_config {
+	enum esb_mode mode;
+	esb_event_handler event_handler;
+	enum esb_bitrate bitrate;
+	enum esb_crc crc;
+	int8_t tx_output_power;
+	uint16_t retransmit_delay;
+	uint16_t retransmit_count;
+	enum esb_tx_mode tx_mode;
+	uint8_t payload_length;
+	bool selective_auto_ack;
+	bool use_fast_ramp_up;
+};
+
+#define ESB_DEFAULT_CONFIG {.mode = ESB_MODE_PTX, .bitrate = ESB_BITRATE_2MBPS, .crc = ESB_CRC_16BIT, \
+		.retransmit_delay = 600, .retransmit_count = 3, .tx_mode = ESB_TXMODE_AUTO, .payload_length = 32}
+
+#define ESB_CREATE_PAYLOAD(_pipe, ...) \
+	{.pipe = _pipe, .length = NUM_VA_ARGS_LESS_1(_pipe, __VA_ARGS__), .data = {__VA_ARGS__}}
+
+int esb_init(const struct esb_config *config);
+void esb_disable(void);
+int esb_start_rx(void);
+int esb_write_payload(const struct esb_payload *payload);
+int esb_read_rx_payload(struct esb_payload *payload);
+int esb_flush_tx(void);
+int esb_set_base_address_0(const uint8_t *addr);
+int esb_set_base_address_1(const uint8_t *addr);
+int esb_set_prefixes(const uint8_t *prefixes, uint8_t num_pipes);
+int esb_enable_pipes(uint8_t enable_mask);
+int esb_set_rf_channel(uint32_t channel);
+
+#endif
@@ -0,0 +1,120 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include <zephyr/ztest.h>
+
+#include "globals.h"
+#include "connection/esb.h"
+#include "connection/esb_packet.h"
+
+#include "mocks.h"
+
+// Cycles per call of the receive and pairing hot paths, printed for comparison between builds
+// native_sim does not advance the cycle counter while code runs, the budgets are only checked on
+// hardware (esb.bench)
+
+#define BENCH_ROUNDS 1000
+#define BENCH_TRACKERS 64 // stored trackers searched by the pairing lookups
+
+// per call, generous for a 64MHz nRF52
+#define BENCH_EVENT_HANDLER_NS 20000
+#define BENCH_PARSE_PAIR_NS 20000
+#define BENCH_ADD_PAIR_NS 20000
+
+static void bench_report(const char *name, uint32_t cycles, uint32_t budget_ns)
+{
+	uint64_t ns = k_cyc_to_ns_floor64(cycles) / BENCH_ROUNDS;
+	TC_PRINT("%s: %u cycles, %llu ns per call\n", name, cycles / BENCH_ROUNDS, ns);
+	if (!cycles)
+		ztest_test_skip(); // simulated time
+	zassert_true(ns < budget_ns, "%s takes %llu ns, budget %u ns", name, ns, budget_ns);
+}
+
+static void *esb_rx_bench_setup(void)
+{
+	while (stored_trackers < BENCH_TRACKERS)
+		esb_add_pair(0xE1E2E3E4E500ULL + stored_trackers, false);
+	return NULL;
+}
+
+// runs after esb_rx, the receiver is paired
+ZTEST_SUITE(esb_rx_bench, NULL, esb_rx_bench_setup, NULL, NULL, NULL);
+
+ZTEST(esb_rx_bench, test_event_handler_cycles)
+{
+	const uint8_t imu_id = 5;
+	struct esb_payload payload = {.length = 16, .pipe = esb_tracker_pipe(imu_id)};
+	struct esb_evt event = {.evt_id = ESB_EVENT_RX_RECEIVED};
+	payload.data[1] = imu_id;
+	int forwarded = mock_forwarded;
+	uint32_t cycles = 0;
+	for (int i = 0; i < BENCH_ROUNDS + DETECTION_THRESHOLD; i++)
+	{
+		payload.pid = i & 3; // a new packet every time, not a retransmit
+		payload.data[2] = i;
+		mock_rx_queue(&payload);
+		uint32_t start = k_cycle_get_32();
+		event_handler(&event);
+		if (i >= DETECTION_THRESHOLD) // discovered by the garbage filter
+			cycles += k_cycle_get_32() - start;
+	}
+	zassert_equal(mock_forwarded - forwarded, BENCH_ROUNDS, "every packet is forwarded");
+	bench_report("event_handler", cycles, BENCH_EVENT_HANDLER_NS);
+}
+
+ZTEST(esb_rx_bench, test_parse_pair_cycles)
+{
+	// a stored tracker asks again, the lookup walks all stored trackers
+	uint64_t addr = stored_tracker_addr[BENCH_TRACKERS - 1];
+	struct esb_payload payload = {.length = 8};
+	struct esb_evt event = {.evt_id = ESB_EVENT_RX_RECEIVED};
+	memcpy(&payload.data[2], &addr, 6);
+	payload.data[0] = esb_pair_checksum(&payload.data[2]);
+	mock_rx_queue(&payload);
+	event_handler(&event); // the request is kept for the pairing thread
+	int trackers = stored_trackers;
+	uint32_t cycles = 0;
+	for (int i = 0; i < BENCH_ROUNDS; i++)
+	{
+		uint32_t start = k_cycle_get_32();
+		esb_parse_pair();
+		cycles += k_cycle_get_32() - start;
+	}
+	zassert_equal(stored_trackers, trackers, "already stored");
+	bench_report("esb_parse_pair", cycles, BENCH_PARSE_PAIR_NS);
+}
+
+ZTEST(esb_rx_bench, test_add_pair_cycles)
+{
+	// pairing from the shell with a stored address only looks it up
+	uint64_t addr = stored_tracker_addr[BENCH_TRACKERS - 1];
+	int writes = mock_sys_writes;
+	uint32_t cycles = 0;
+	for (int i = 0; i < BENCH_ROUNDS; i++)
+	{
+		uint32_t start = k_cycle_get_32();
+		esb_add_pair(addr, true);
+		cycles += k_cycle_get_32() - start;
+	}
+	zassert_equal(mock_sys_writes, writes, "already stored");
+	bench_report("esb_add_pair", cycles, BENCH_ADD_PAIR_NS);
+}
@@ -0,0 +1,261 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include <zephyr/ztest.h>
+
+#include "globals.h"
+#include "system/system.h"
+#include "connection/esb.h"
+#include "connection/esb_packet.h"
+#include "connection/telemetry.h"
+
+#include "mocks.h"
+
+// esb.c runs with its threads, the pairing thread answers while the test sleeps
+
+static void rx_event(void)
+{
+	struct esb_evt event = {.evt_id = ESB_EVENT_RX_RECEIVED};
+	event_handler(&event);
+}
+
+static uint8_t pair_request(uint64_t addr, bool valid)
+{
+	struct esb_payload payload = {.length = 8};
+	memcpy(&payload.data[2], &addr, 6);
+	uint8_t checksum = esb_pair_checksum(&payload.data[2]);
+	payload.data[0] = valid ? checksum : checksum ^ 0xFF;
+	payload.data[1] = 0; // first packet in pairing burst
+	mock_rx_queue(&payload);
+	rx_event();
+	k_msleep(5);
+	return checksum;
+}
+
+static void tracker_packet(uint8_t imu_id, uint8_t pid, uint8_t type, uint8_t value)
+{
+	struct esb_payload payload = {.length = 16, .pipe = esb_tracker_pipe(imu_id), .pid = pid};
+	payload.data[0] = type;
+	payload.data[1] = imu_id;
+	payload.data[2] = value;
+	mock_rx_queue(&payload);
+	rx_event();
+}
+
+// The garbage filter drops the first DETECTION_THRESHOLD packets of a tracker
+static void discover(uint8_t imu_id)
+{
+	for (int i = 0; i < DETECTION_THRESHOLD; i++)
+		tracker_packet(imu_id, i & 3, 0, i);
+	zassert_equal(mock_forwarded, 0, "forwarded before discovery");
+}
+
+static void *esb_pair_setup(void)
+{
+	k_msleep(10); // esb_thread finds no stored tracker and starts pairing
+	return NULL;
+}
+
+static void esb_pair_teardown(void *fixture)
+{
+	esb_finish_pair();
+	k_msleep(100);
+}
+
+ZTEST_SUITE(esb_pair, NULL, esb_pair_setup, NULL, NULL, esb_pair_teardown);
+
+ZTEST(esb_pair, test_pair_invalid)
+{
+	zassert_true(mock_rx_started, "not pairing");
+	int trackers = stored_trackers;
+	int writes = mock_sys_writes;
+	pair_request(0xA1A2A3A4A5A6ULL, false);
+	zassert_equal(stored_trackers, trackers);
+	zassert_equal(mock_sys_writes, writes);
+	zassert_equal(mock_tx_last.length, 8);
+	zassert_equal(mock_tx_last.data[0], 0, "response must be invalidated");
+}
+
+ZTEST(esb_pair, test_pair_tracker)
+{
+	const uint64_t addr = 0xB1B2B3B4B5B6ULL;
+	uint8_t id = stored_trackers;
+	int writes = mock_sys_writes;
+	uint8_t checksum = pair_request(addr, true);
+	zassert_equal(stored_trackers, id + 1);
+	zassert_equal(stored_tracker_addr[id], addr);
+	zassert_equal(mock_sys_writes, writes + 2, "address and count are stored");
+	zassert_equal(mock_sys_write_last_id, STORED_TRACKERS);
+	zassert_equal(mock_tx_last.length, 8);
+	zassert_equal(mock_tx_last.data[0], checksum);
+	zassert_equal(mock_tx_last.data[1], id);
+	uint64_t receiver_addr = MOCK_DEVICE_ADDR;
+	zassert_mem_equal(&mock_tx_last.data[2], &receiver_addr, 6);
+
+	// the tracker did not get the response and asks again
+	int tx_count = mock_tx_count;
+	pair_request(addr, true);
+	zassert_equal(stored_trackers, id + 1);
+	zassert_equal(mock_sys_writes, writes + 2);
+	zassert_equal(mock_tx_count, tx_count + 1);
+	zassert_equal(mock_tx_last.data[1], id, "same id for a known tracker");
+}
+
+ZTEST(esb_pair, test_pair_full)
+{
+	// the last id is TELEMETRY_ID and never given to a tracker
+	int trackers = stored_trackers;
+	while (stored_trackers < TELEMETRY_ID)
+		esb_add_pair(0xE1E2E3E4E500ULL + stored_trackers, false);
+	int writes = mock_sys_writes;
+	esb_add_pair(0xF1F2F3F4F5F6ULL, true);
+	zassert_equal(stored_trackers, TELEMETRY_ID, "added past the last tracker id");
+	pair_request(0xF1F2F3F4F5F6ULL, true);
+	zassert_equal(stored_trackers, TELEMETRY_ID, "paired past the last tracker id");
+	zassert_equal(mock_sys_writes, writes);
+	zassert_equal(mock_tx_last.data[0], 0, "response must be invalidated");
+
+	// stored trackers still pair
+	uint8_t checksum = pair_request(stored_tracker_addr[TELEMETRY_ID - 1], true);
+	zassert_equal(mock_tx_last.data[0], checksum);
+	zassert_equal(mock_tx_last.data[1], TELEMETRY_ID - 1);
+
+	while (stored_trackers > trackers)
+		esb_pop_pair();
+}
+
+ZTEST(esb_pair, test_pair_default_radio)
+{
+	// stored while pairing, applied once paired
+	esb_set_radio_profile(ESB_PROFILE_LONG_RANGE);
+	esb_set_channel(40);
+	esb_finish_pair();
+	k_msleep(100);
+	zassert_equal(mock_esb_config.bitrate, ESB_BITRATE_1MBPS, "paired receiver uses the stored profile");
+	zassert_equal(mock_rf_channel, 40, "paired receiver uses the stored channel");
+
+	// trackers that are not paired yet only know the default profile and channel
+	esb_reset_pair();
+	k_msleep(150); // esb_thread starts pairing again
+	zassert_true(mock_rx_started, "not pairing");
+	zassert_equal(mock_esb_config.bitrate, ESB_BITRATE_2MBPS, "pairing must use the default profile");
+	zassert_false(mock_esb_config.use_fast_ramp_up);
+	zassert_equal(mock_rf_channel, 2, "pairing must use the default channel");
+
+	esb_set_radio_profile(ESB_PROFILE_DEFAULT);
+	esb_set_channel(-1);
+}
+
+#define RX_TRACKERS 5
+
+static void *esb_rx_setup(void)
+{
+	esb_finish_pair();
+	while (stored_trackers < RX_TRACKERS)
+		esb_add_pair(0xC1C2C3C4C500ULL + stored_trackers, false);
+	k_msleep(100);
+	return NULL;
+}
+
+static void esb_rx_before(void *fixture)
+{
+	mock_forwarded = 0;
+}
+
+ZTEST_SUITE(esb_rx, NULL, esb_rx_setup, esb_rx_before, NULL, NULL);
+
+ZTEST(esb_rx, test_add_pair)
+{
+	int trackers = stored_trackers;
+	int writes = mock_sys_writes;
+	esb_add_pair(stored_tracker_addr[0], true);
+	zassert_equal(stored_trackers, trackers, "already stored");
+	zassert_equal(mock_sys_writes, writes);
+	esb_add_pair(0xD1D2D3D4D5D6ULL, true);
+	zassert_equal(stored_trackers, trackers + 1);
+	zassert_equal(stored_tracker_addr[trackers], 0xD1D2D3D4D5D6ULL);
+	zassert_equal(mock_sys_writes, writes + 2);
+}
+
+ZTEST(esb_rx, test_garbage_filter)
+{
+	discover(1);
+	tracker_packet(1, 0, 0, 100);
+	zassert_equal(mock_forwarded, 1);
+	zassert_equal(mock_forwarded_last_imu_id, 1);
+}
+
+ZTEST(esb_rx, test_unknown_tracker)
+{
+	uint8_t imu_id = stored_trackers;
+	for (int i = 0; i < DETECTION_THRESHOLD * 2; i++)
+		tracker_packet(imu_id, i & 3, 0, i);
+	zassert_equal(mock_forwarded, 0);
+}
+
+ZTEST(esb_rx, test_duplicate)
+{
+	discover(2);
+	tracker_packet(2, 1, 0, 100);
+	zassert_equal(mock_forwarded, 1);
+	tracker_packet(2, 1, 0, 100); // ack was lost, same packet again
+	zassert_equal(mock_forwarded, 1);
+	tracker_packet(2, 2, 0, 101);
+	zassert_equal(mock_forwarded, 2);
+}
+
+ZTEST(esb_rx, test_reserved)
+{
+	discover(3);
+	tracker_packet(3, 1, ESB_PACKET_TYPE_RESERVED, 100);
+	zassert_equal(mock_forwarded, 0);
+	tracker_packet(3, 2, 0, 101);
+	zassert_equal(mock_forwarded, 1);
+}
+
+ZTEST(esb_rx, test_pool_exhausted)
+{
+	discover(4);
+	int pool_free = mock_forward_pool_free;
+	mock_forward_pool_free = 0;
+	tracker_packet(4, 1, 0, 100); // read into the scratch record and dropped
+	mock_forward_pool_free = pool_free;
+	zassert_equal(mock_forwarded, 0);
+	tracker_packet(4, 2, 0, 101);
+	zassert_equal(mock_forwarded, 1);
+}
+
+ZTEST(esb_rx, test_rx_fifo_drain)
+{
+	discover(0);
+	int pool_free = mock_forward_pool_free;
+	struct esb_payload payload = {.length = 16};
+	for (int i = 0; i < 3; i++) // one event for several packets
+	{
+		payload.pid = i;
+		payload.data[2] = i;
+		mock_rx_queue(&payload);
+	}
+	rx_event();
+	zassert_equal(mock_forwarded, 3);
+	zassert_equal(mock_forward_pool_free, pool_free, "all slots returned");
+}
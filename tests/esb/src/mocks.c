@@ -0,0 +1,227 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include "globals.h"
+#include "system/system.h"
+#include "system/retained.h"
+#include "connection/forward.h"
+#include "connection/timer.h"
+
+#include "mocks.h"
+
+// Everything esb.c links against besides the protocol logic in esb_packet.c
+
+uint16_t stored_trackers;
+uint64_t stored_tracker_addr[MAX_TRACKERS];
+
+static struct retained_data mock_retained;
+struct retained_data *const retained = &mock_retained;
+
+bool retained_valid(void)
+{
+	return true; // start from the empty tracker table above, never read NVS
+}
+
+void retained_update(void)
+{
+}
+
+void retained_loaded(uint8_t part)
+{
+}
+
+int mock_sys_writes;
+uint16_t mock_sys_write_last_id;
+
+void sys_write(uint16_t id, void *retained_ptr, const void *data, size_t len)
+{
+	if (retained_ptr)
+		memcpy(retained_ptr, data, len);
+	mock_sys_writes++;
+	mock_sys_write_last_id = id;
+}
+
+void sys_read(uint16_t id, void *data, size_t len)
+{
+	memset(data, 0, len);
+}
+
+uint64_t sys_device_addr(void)
+{
+	return MOCK_DEVICE_ADDR;
+}
+
+int clocks_request(void)
+{
+	return 0;
+}
+
+int clocks_wait(void)
+{
+	return 0;
+}
+
+void sys_boot_phase(enum sys_boot_phase phase)
+{
+}
+
+void set_led(enum sys_led_pattern led_pattern, int priority)
+{
+}
+
+void set_status(enum sys_status status, bool set)
+{
+}
+
+void timer_init(void)
+{
+}
+
+void timer_update_slot(void)
+{
+}
+
+uint32_t timer_frame_slot(void)
+{
+	return 0;
+}
+
+#define MOCK_FORWARD_POOL_SIZE 8
+
+static struct rx_record forward_pool[MOCK_FORWARD_POOL_SIZE];
+static bool forward_pool_used[MOCK_FORWARD_POOL_SIZE];
+int mock_forward_pool_free = MOCK_FORWARD_POOL_SIZE;
+int mock_forwarded;
+uint8_t mock_forwarded_last_imu_id;
+
+struct rx_record *forward_alloc(void)
+{
+	if (mock_forward_pool_free <= 0)
+		return NULL;
+	for (int i = 0; i < MOCK_FORWARD_POOL_SIZE; i++)
+	{
+		if (!forward_pool_used[i])
+		{
+			forward_pool_used[i] = true;
+			mock_forward_pool_free--;
+			return &forward_pool[i];
+		}
+	}
+	return NULL;
+}
+
+void forward_free(struct rx_record *record)
+{
+	int i = record - forward_pool;
+	__ASSERT(i >= 0 && i < MOCK_FORWARD_POOL_SIZE && forward_pool_used[i], "not a pool slot");
+	forward_pool_used[i] = false;
+	mock_forward_pool_free++;
+}
+
+void forward_submit(struct rx_record *record)
+{
+	mock_forwarded++;
+	mock_forwarded_last_imu_id = record->payload.data[1];
+	forward_free(record); // the forward thread is done with it right away
+}
+
+#define MOCK_RX_FIFO_SIZE 8
+
+static struct esb_payload rx_fifo[MOCK_RX_FIFO_SIZE];
+static int rx_fifo_head, rx_fifo_count;
+struct esb_payload mock_tx_last;
+int mock_tx_count;
+bool mock_rx_started;
+struct esb_config mock_esb_config;
+int mock_rf_channel = -1;
+
+void mock_rx_queue(const struct esb_payload *payload)
+{
+	__ASSERT(rx_fifo_count < MOCK_RX_FIFO_SIZE, "rx fifo full");
+	rx_fifo[(rx_fifo_head + rx_fifo_count++) % MOCK_RX_FIFO_SIZE] = *payload;
+}
+
+int esb_read_rx_payload(struct esb_payload *payload)
+{
+	if (!rx_fifo_count)
+		return -ENODATA;
+	*payload = rx_fifo[rx_fifo_head];
+	rx_fifo_head = (rx_fifo_head + 1) % MOCK_RX_FIFO_SIZE;
+	rx_fifo_count--;
+	return 0;
+}
+
+int esb_write_payload(const struct esb_payload *payload)
+{
+	mock_tx_last = *payload;
+	mock_tx_count++;
+	return 0;
+}
+
+int esb_init(const struct esb_config *config)
+{
+	mock_esb_config = *config;
+	mock_rx_started = false;
+	return 0;
+}
+
+void esb_disable(void)
+{
+	mock_rx_started = false;
+}
+
+int esb_start_rx(void)
+{
+	mock_rx_started = true;
+	return 0;
+}
+
+int esb_flush_tx(void)
+{
+	return 0;
+}
+
+int esb_set_base_address_0(const uint8_t *addr)
+{
+	return 0;
+}
+
+int esb_set_base_address_1(const uint8_t *addr)
+{
+	return 0;
+}
+
+int esb_set_prefixes(const uint8_t *prefixes, uint8_t num_pipes)
+{
+	return 0;
+}
+
+int esb_enable_pipes(uint8_t enable_mask)
+{
+	return 0;
+}
+
+int esb_set_rf_channel(uint32_t channel)
+{
+	mock_rf_channel = channel;
+	return 0;
+}
@@ -0,0 +1,49 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#ifndef SLIMENRF_MOCKS
+#define SLIMENRF_MOCKS
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <esb.h>
+
+#define MOCK_DEVICE_ADDR 0x123456789ABCULL
+
+// Radio, packets queued here are read by event_handler on the next ESB_EVENT_RX_RECEIVED
+void mock_rx_queue(const struct esb_payload *payload);
+extern struct esb_payload mock_tx_last; // last payload written to the TX FIFO
+extern int mock_tx_count;
+extern bool mock_rx_started;
+extern struct esb_config mock_esb_config; // last configuration passed to esb_init
+extern int mock_rf_channel; // last channel set, -1 if never set
+
+// NVS, writes are counted per id
+extern int mock_sys_writes;
+extern uint16_t mock_sys_write_last_id;
+
+// Forwarding, mock_forward_pool_free slots are handed out before forward_alloc fails
+extern int mock_forward_pool_free;
+extern int mock_forwarded;
+extern uint8_t mock_forwarded_last_imu_id;
+
+#endif
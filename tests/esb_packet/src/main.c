@@ -0,0 +1,135 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "esb_packet.h"
+
+ZTEST_SUITE(esb_packet, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(esb_packet, test_classify)
+{
+	uint8_t data[32] = {0};
+	zassert_equal(esb_packet_classify(data, 8), ESB_PACKET_PAIR);
+	zassert_equal(esb_packet_classify(data, 12), ESB_PACKET_COEXIST);
+	zassert_equal(esb_packet_classify(data, 16), ESB_PACKET_TRACKER);
+	data[0] = ESB_PACKET_TYPE_RESERVED - 1;
+	zassert_equal(esb_packet_classify(data, 16), ESB_PACKET_TRACKER);
+	data[0] = ESB_PACKET_TYPE_RESERVED;
+	zassert_equal(esb_packet_classify(data, 16), ESB_PACKET_RESERVED);
+	data[0] = 255;
+	zassert_equal(esb_packet_classify(data, 16), ESB_PACKET_RESERVED);
+	zassert_equal(esb_packet_classify(data, 0), ESB_PACKET_INVALID);
+	zassert_equal(esb_packet_classify(data, 15), ESB_PACKET_INVALID);
+	zassert_equal(esb_packet_classify(data, 20), ESB_PACKET_INVALID); // sync beacon, only sent by the receiver
+	zassert_equal(esb_packet_classify(data, 32), ESB_PACKET_INVALID);
+}
+
+ZTEST(esb_packet, test_pair_checksum)
+{
+	const uint8_t addr[6] = {0xBC, 0x9A, 0x78, 0x56, 0x34, 0x12};
+	zassert_equal(esb_pair_checksum(addr), 0x0D); // crc8 ccitt, initial value 0x07
+	const uint8_t zero_crc[6] = {0x07, 0, 0, 0, 0, 0}; // crc is 0
+	zassert_equal(esb_pair_checksum(zero_crc), 8); // zero is not a valid checksum
+}
+
+ZTEST(esb_packet, test_pair_valid)
+{
+	uint8_t pairing_buf[8] = {0, 0, 0xBC, 0x9A, 0x78, 0x56, 0x34, 0x12};
+	pairing_buf[0] = esb_pair_checksum(&pairing_buf[2]);
+	zassert_true(esb_pair_valid(pairing_buf));
+	zassert_equal(esb_pair_addr(pairing_buf), 0x123456789ABCULL);
+	pairing_buf[1] = 2; // packet flag is not covered
+	zassert_true(esb_pair_valid(pairing_buf));
+	pairing_buf[7] ^= 0x01;
+	zassert_false(esb_pair_valid(pairing_buf));
+	pairing_buf[7] ^= 0x01;
+	pairing_buf[0] = 0;
+	zassert_false(esb_pair_valid(pairing_buf));
+}
+
+ZTEST(esb_packet, test_pair_response_addr)
+{
+	zassert_equal(esb_pair_response_addr(0x123456789ABCULL, 5, 0x42), 0x123456789ABC0542ULL);
+	zassert_equal(esb_pair_response_addr(0xFFFF123456789ABCULL, 255, 0x08), 0x123456789ABCFF08ULL,
+			"only 48 bits of the receiver address are used");
+}
+
+ZTEST(esb_packet, test_tracker_pipe)
+{
+	zassert_equal(esb_tracker_pipe(0), 0);
+	zassert_equal(esb_tracker_pipe(9), 1);
+	zassert_equal(esb_tracker_pipe(255), 7);
+	zassert_equal(esb_tracker_pipe_mask(0), 0x00);
+	zassert_equal(esb_tracker_pipe_mask(3), 0x07);
+	zassert_equal(esb_tracker_pipe_mask(8), 0xFF);
+	zassert_equal(esb_tracker_pipe_mask(200), 0xFF);
+}
+
+ZTEST(esb_packet, test_addr_from_device)
+{
+	uint8_t base_addr_0[4], base_addr_1[4], addr_prefix[8];
+	esb_addr_from_device(0x123456789ABCULL, base_addr_0, base_addr_1, addr_prefix);
+	zassert_mem_equal(base_addr_0, ((uint8_t[]){0xBC, 0x9A, 0x78, 0x56}), 4);
+	zassert_mem_equal(base_addr_1, ((uint8_t[]){0xF0, 0xCE, 0xAC, 0x8A}), 4); // + byte 4
+	zassert_mem_equal(addr_prefix, ((uint8_t[]){0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19}), 8); // byte 5 + pipe
+
+	// 0x00, 0x55 and 0xAA are not valid address bytes
+	esb_addr_from_device(0xAA0000AA5500ULL, base_addr_0, base_addr_1, addr_prefix);
+	zassert_mem_equal(base_addr_0, ((uint8_t[]){0x08, 0x5D, 0xB2, 0x08}), 4);
+	zassert_mem_equal(base_addr_1, ((uint8_t[]){0x08, 0x5D, 0xB2, 0x08}), 4);
+	zassert_mem_equal(addr_prefix, ((uint8_t[]){0xB2, 0xAB, 0xAC, 0xAD, 0xAE, 0xAF, 0xB0, 0xB1}), 8);
+
+	// bits above the 48 bit device address are ignored
+	uint8_t prefix_high[8];
+	esb_addr_from_device(0xFFFF123456789ABCULL, base_addr_0, base_addr_1, prefix_high);
+	esb_addr_from_device(0x123456789ABCULL, base_addr_0, base_addr_1, addr_prefix);
+	zassert_mem_equal(prefix_high, addr_prefix, 8);
+}
+
+ZTEST(esb_packet, test_seq_update)
+{
+	struct esb_seq seq = {0};
+	uint8_t data[16] = {0};
+	zassert_equal(esb_seq_update(&seq, 1, data), 0); // first packet
+	zassert_equal(esb_seq_update(&seq, 1, data), -1); // retransmit
+	data[2]++;
+	zassert_equal(esb_seq_update(&seq, 2, data), 0); // next packet
+	data[2]++;
+	zassert_equal(esb_seq_update(&seq, 1, data), 2); // pid 3 and 0 lost // 2 -> 1 wraps around
+	data[2]++;
+	zassert_equal(esb_seq_update(&seq, 1, data), 3); // same pid with other data, 3 lost
+	zassert_equal(esb_seq_update(&seq, 1, data), -1);
+	data[2]++;
+	zassert_equal(esb_seq_update(&seq, 2, data), 0);
+}
+
+ZTEST(esb_packet, test_airtime)
+{
+	zassert_equal(esb_airtime(ESB_PROFILE_DEFAULT, 0), 41); // 2 byte preamble, address, control field and CRC at 2Mbit
+	zassert_equal(esb_airtime(ESB_PROFILE_DEFAULT, ESB_SYNC_LENGTH), 121);
+	zassert_equal(esb_airtime(ESB_PROFILE_LONG_RANGE, ESB_SYNC_LENGTH), 233); // 1 byte preamble at 1Mbit
+	zassert_equal(esb_transaction_time(ESB_PROFILE_DEFAULT, ESB_SYNC_LENGTH, false), 140 + 121);
+	zassert_equal(esb_transaction_time(ESB_PROFILE_LOW_LATENCY, ESB_SYNC_LENGTH, false), 40 + 121); // fast ramp-up
+	zassert_equal(esb_transaction_time(ESB_PROFILE_DEFAULT, 8, true), 140 + 73 + 6 + 140 + 41); // ACK after the turnaround
+}
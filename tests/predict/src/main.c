@@ -0,0 +1,181 @@
+/*
+	SlimeVR Code is placed under the MIT license
+	Copyright (c) 2025 SlimeVR Contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+*/
+#include <math.h>
+#include <stdlib.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "globals.h"
+#include "connection/predict.h"
+#include "connection/telemetry.h"
+
+// Synthetic tracker orientation streams, replayed with their packet times while runs of packets are
+// left out. The prediction thread of predict.c fills the gaps, each predicted sample is compared to
+// the packet that was left out.
+
+struct orientation_sample {
+	uint32_t time; // us since the first packet
+	int16_t q[4]; // x, y, z, w (q15) as in the packet
+};
+
+struct orientation_stream {
+	const struct orientation_sample *samples;
+	size_t count;
+};
+
+// Arm swing while walking and a head turn up to 180 deg/s, 100Hz with +-200us jitter. A tracker
+// capture exported with scripts/predict_eval.py --export can replace them
+#include "synthetic_streams.h"
+
+#define WARMUP 8 // packets between gaps
+#define RUN_MAX CONFIG_RX_PREDICT_MAX
+#define SAMPLES_MAX 1024
+#define PREDICT_P99_MAX_DEG 1.0
+
+uint16_t stored_trackers = ARRAY_SIZE(streams) * RUN_MAX;
+uint64_t stored_tracker_addr[MAX_TRACKERS];
+
+struct predicted_sample {
+	uint8_t imu_id;
+	uint8_t missed;
+	int16_t q[4];
+};
+
+static struct predicted_sample predicted[RUN_MAX + 1];
+static int predicted_count;
+
+// Predicted samples are written to the hid layer, from the prediction thread
+void hid_write_packet_n(uint8_t *data, uint8_t rssi)
+{
+	if (data[0] != TELEMETRY_PREDICTED || predicted_count == ARRAY_SIZE(predicted))
+		return;
+	struct predicted_sample *sample = &predicted[predicted_count++];
+	sample->imu_id = data[2];
+	for (int i = 0; i < 4; i++)
+		sample->q[i] = sys_get_le16(&data[3 + i * 2]);
+	sample->missed = data[11];
+}
+
+// Angle between two orientations (deg)
+static double angle(const int16_t *a, const int16_t *b)
+{
+	double dot = 0, norm_a = 0, norm_b = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		dot += (double)a[i] * b[i];
+		norm_a += (double)a[i] * a[i];
+		norm_b += (double)b[i] * b[i];
+	}
+	double c = fabs(dot) / sqrt(norm_a * norm_b);
+	return 2 * acos(MIN(c, 1.0)) * 180 / M_PI;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+	double d = *(const double *)a - *(const double *)b;
+	return (d > 0) - (d < 0);
+}
+
+static double percentile(double *values, int count, int p)
+{
+	qsort(values, count, sizeof(values[0]), compare_double);
+	return values[MIN(count - 1, count * p / 100)];
+}
+
+struct predict_errors {
+	double predicted[SAMPLES_MAX];
+	double held[SAMPLES_MAX]; // last received orientation, what the host shows without prediction
+	int count;
+};
+
+static struct predict_errors errors;
+
+static void check_gap(uint8_t imu_id, const struct orientation_sample *samples, int gap, int run)
+{
+	zassert_equal(predicted_count, run, "tracker %d: %d predicted samples for %d missing packets", imu_id, predicted_count, run);
+	for (int i = 0; i < predicted_count; i++)
+	{
+		zassert_equal(predicted[i].imu_id, imu_id);
+		zassert_equal(predicted[i].missed, i + 1);
+		const struct orientation_sample *actual = &samples[gap + i];
+		errors.predicted[errors.count] = angle(predicted[i].q, actual->q);
+		errors.held[errors.count] = angle(samples[gap - 1].q, actual->q);
+		errors.count++;
+	}
+	predicted_count = 0;
+}
+
+static void replay(uint8_t imu_id, const struct orientation_stream *stream, int run)
+{
+	int cycle = WARMUP + run;
+	int64_t start = k_ticks_to_us_ceil64(k_uptime_ticks()) + 1000;
+	errors.count = 0;
+	predicted_count = 0;
+	for (int i = 0; i < stream->count; i++)
+	{
+		const struct orientation_sample *sample = &stream->samples[i];
+		k_sleep(K_TIMEOUT_ABS_US(start + sample->time));
+		if (i % cycle >= WARMUP) // left out, the prediction thread runs while waiting for the next packet
+			continue;
+		if (i >= cycle && i % cycle == 0)
+			check_gap(imu_id, stream->samples, i - run, run);
+		uint8_t packet[16] = {1, imu_id};
+		for (int n = 0; n < 4; n++)
+			sys_put_le16(sample->q[n], &packet[2 + n * 2]);
+		unsigned int key = irq_lock(); // as in the forwarding thread
+		predict_update(imu_id, packet, k_cycle_get_32());
+		irq_unlock(key);
+	}
+	k_msleep(100); // past CONFIG_RX_PREDICT_TIMEOUT, the last gap is not checked
+	predicted_count = 0;
+}
+
+static void check_stream(int index)
+{
+	for (int run = 1; run <= RUN_MAX; run++)
+	{
+		uint8_t imu_id = index * RUN_MAX + run - 1;
+		replay(imu_id, &streams[index], run);
+		zassert_true(errors.count > 0);
+		double predicted_p50 = percentile(errors.predicted, errors.count, 50);
+		double predicted_p99 = percentile(errors.predicted, errors.count, 99);
+		double held_p50 = percentile(errors.held, errors.count, 50);
+		double held_p99 = percentile(errors.held, errors.count, 99);
+		TC_PRINT("stream %d, %d missing: %d samples, predicted p50 %.3f p99 %.3f, held p50 %.3f p99 %.3f (deg)\n",
+				index, run, errors.count, predicted_p50, predicted_p99, held_p50, held_p99);
+		zassert_true(predicted_p99 < PREDICT_P99_MAX_DEG, "prediction error p99 %.3f deg", predicted_p99);
+		zassert_true(predicted_p50 * 4 < held_p50, "prediction does not improve on holding the last sample");
+	}
+}
+
+ZTEST_SUITE(predict, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(predict, test_stream_0)
+{
+	check_stream(0);
+}
+
+ZTEST(predict, test_stream_1)
+{
+	check_stream(1);
+}
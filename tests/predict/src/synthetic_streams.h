@@ -0,0 +1,412 @@
+/* Synthetic orientation streams, in the format of scripts/predict_eval.py --export */
+
+static const struct orientation_sample stream_0[] = {
+	{0, {3362, -10086, 6724, 30257}},
+	{9931, {3335, -10036, 6794, 30261}},
+	{20131, {3320, -9973, 6870, 30267}},
+	{29899, {3315, -9898, 6952, 30273}},
+	{40085, {3322, -9812, 7040, 30280}},
+	{50017, {3340, -9716, 7133, 30287}},
+	{59894, {3369, -9611, 7231, 30294}},
+	{70073, {3410, -9498, 7334, 30300}},
+	{79885, {3462, -9378, 7442, 30306}},
+	{90044, {3526, -9254, 7553, 30309}},
+	{99898, {3601, -9125, 7668, 30310}},
+	{109907, {3687, -8994, 7786, 30309}},
+	{120040, {3785, -8862, 7907, 30304}},
+	{130201, {3894, -8730, 8031, 30296}},
+	{139920, {4014, -8600, 8156, 30284}},
+	{149960, {4145, -8472, 8283, 30268}},
+	{160121, {4286, -8349, 8411, 30248}},
+	{170250, {4438, -8231, 8540, 30222}},
+	{180101, {4600, -8119, 8669, 30191}},
+	{190029, {4771, -8015, 8797, 30155}},
+	{200261, {4952, -7919, 8925, 30114}},
+	{209889, {5142, -7831, 9051, 30068}},
+	{220214, {5339, -7753, 9176, 30015}},
+	{229986, {5545, -7685, 9299, 29958}},
+	{239928, {5757, -7627, 9420, 29895}},
+	{249918, {5976, -7579, 9537, 29827}},
+	{259994, {6201, -7541, 9652, 29753}},
+	{270197, {6430, -7514, 9764, 29675}},
+	{279943, {6663, -7496, 9872, 29592}},
+	{290103, {6899, -7488, 9976, 29505}},
+	{300126, {7137, -7489, 10077, 29414}},
+	{310019, {7376, -7498, 10173, 29319}},
+	{320090, {7615, -7515, 10265, 29222}},
+	{329896, {7853, -7539, 10354, 29121}},
+	{339894, {8088, -7568, 10438, 29019}},
+	{349953, {8321, -7603, 10518, 28915}},
+	{360143, {8549, -7641, 10594, 28810}},
+	{370042, {8772, -7682, 10667, 28705}},
+	{379996, {8988, -7725, 10736, 28601}},
+	{390105, {9197, -7769, 10801, 28498}},
+	{400052, {9398, -7813, 10864, 28396}},
+	{409990, {9589, -7856, 10923, 28298}},
+	{420188, {9769, -7897, 10980, 28202}},
+	{430150, {9938, -7935, 11035, 28111}},
+	{439968, {10096, -7969, 11088, 28025}},
+	{450100, {10240, -7998, 11139, 27943}},
+	{460081, {10371, -8023, 11189, 27868}},
+	{470221, {10488, -8042, 11237, 27800}},
+	{480162, {10590, -8055, 11284, 27738}},
+	{489986, {10677, -8061, 11331, 27684}},
+	{500263, {10748, -8061, 11376, 27637}},
+	{509918, {10806, -8054, 11423, 27597}},
+	{520038, {10845, -8041, 11467, 27568}},
+	{530173, {10868, -8021, 11510, 27546}},
+	{539931, {10875, -7994, 11553, 27534}},
+	{550066, {10866, -7962, 11594, 27529}},
+	{559886, {10841, -7925, 11634, 27533}},
+	{570138, {10800, -7883, 11672, 27545}},
+	{580176, {10743, -7837, 11709, 27565}},
+	{590100, {10672, -7788, 11743, 27592}},
+	{600221, {10586, -7736, 11775, 27626}},
+	{609996, {10486, -7683, 11804, 27666}},
+	{620149, {10373, -7629, 11830, 27713}},
+	{630108, {10246, -7575, 11852, 27765}},
+	{640102, {10108, -7524, 11870, 27822}},
+	{650053, {9959, -7474, 11884, 27883}},
+	{660206, {9799, -7429, 11892, 27948}},
+	{670248, {9629, -7388, 11896, 28017}},
+	{680060, {9451, -7354, 11893, 28087}},
+	{690136, {9264, -7326, 11885, 28160}},
+	{699895, {9071, -7305, 11871, 28234}},
+	{710151, {8872, -7294, 11850, 28309}},
+	{720129, {8668, -7292, 11823, 28384}},
+	{730268, {8460, -7300, 11789, 28459}},
+	{740199, {8248, -7320, 11748, 28533}},
+	{749984, {8034, -7350, 11701, 28605}},
+	{760025, {7819, -7392, 11647, 28676}},
+	{770138, {7603, -7447, 11586, 28745}},
+	{779880, {7387, -7513, 11519, 28811}},
+	{790055, {7171, -7591, 11446, 28874}},
+	{799938, {6957, -7681, 11367, 28934}},
+	{809917, {6745, -7782, 11281, 28990}},
+	{819894, {6536, -7894, 11191, 29043}},
+	{830178, {6330, -8016, 11095, 29091}},
+	{839922, {6128, -8148, 10995, 29136}},
+	{849970, {5930, -8288, 10891, 29177}},
+	{860027, {5736, -8436, 10783, 29213}},
+	{870219, {5548, -8591, 10671, 29245}},
+	{879903, {5365, -8750, 10557, 29274}},
+	{890050, {5187, -8913, 10440, 29298}},
+	{900090, {5016, -9079, 10322, 29319}},
+	{910224, {4851, -9246, 10202, 29337}},
+	{920198, {4692, -9412, 10081, 29352}},
+	{930216, {4540, -9576, 9960, 29364}},
+	{939982, {4394, -9737, 9840, 29373}},
+	{950037, {4256, -9894, 9720, 29381}},
+	{960014, {4125, -10044, 9602, 29388}},
+	{970224, {4001, -10186, 9485, 29394}},
+	{980254, {3886, -10319, 9370, 29400}},
+	{989931, {3778, -10443, 9259, 29406}},
+	{999941, {3678, -10555, 9150, 29412}},
+	{1009963, {3586, -10655, 9044, 29420}},
+	{1019964, {3503, -10742, 8943, 29430}},
+	{1030064, {3428, -10815, 8845, 29441}},
+	{1040106, {3363, -10873, 8752, 29455}},
+	{1049976, {3306, -10917, 8664, 29472}},
+	{1059872, {3259, -10945, 8580, 29491}},
+	{1070038, {3221, -10958, 8501, 29513}},
+	{1080018, {3193, -10956, 8428, 29538}},
+	{1090097, {3174, -10938, 8359, 29566}},
+	{1100252, {3166, -10905, 8296, 29597}},
+	{1110147, {3168, -10857, 8238, 29630}},
+	{1120077, {3181, -10795, 8185, 29666}},
+	{1130118, {3204, -10720, 8137, 29704}},
+	{1140141, {3239, -10632, 8095, 29744}},
+	{1149892, {3284, -10533, 8057, 29784}},
+	{1160230, {3340, -10423, 8024, 29826}},
+	{1170182, {3408, -10303, 7996, 29867}},
+	{1180220, {3487, -10176, 7971, 29908}},
+	{1190190, {3577, -10041, 7951, 29948}},
+	{1200027, {3679, -9901, 7935, 29987}},
+	{1210030, {3792, -9756, 7922, 30024}},
+	{1219912, {3917, -9609, 7912, 30058}},
+	{1230124, {4053, -9461, 7905, 30088}},
+	{1239895, {4200, -9312, 7901, 30116}},
+	{1249897, {4358, -9166, 7898, 30139}},
+	{1259954, {4527, -9022, 7898, 30158}},
+	{1269935, {4706, -8882, 7899, 30172}},
+	{1280007, {4895, -8747, 7900, 30180}},
+	{1289892, {5095, -8619, 7902, 30184}},
+	{1299871, {5303, -8499, 7905, 30181}},
+	{1309931, {5520, -8386, 7907, 30173}},
+	{1319911, {5746, -8283, 7909, 30159}},
+	{1330016, {5979, -8190, 7910, 30139}},
+	{1339881, {6219, -8106, 7910, 30113}},
+	{1350220, {6465, -8033, 7908, 30081}},
+	{1360116, {6717, -7971, 7905, 30043}},
+	{1369930, {6973, -7920, 7900, 30000}},
+	{1379971, {7233, -7879, 7892, 29951}},
+	{1390009, {7496, -7849, 7883, 29897}},
+	{1400016, {7761, -7828, 7871, 29838}},
+	{1409920, {8026, -7817, 7856, 29774}},
+	{1420210, {8292, -7815, 7839, 29706}},
+	{1430268, {8556, -7820, 7820, 29635}},
+	{1440057, {8819, -7833, 7798, 29560}},
+	{1450064, {9078, -7852, 7774, 29483}},
+	{1459905, {9333, -7876, 7748, 29404}},
+	{1469911, {9583, -7905, 7720, 29323}},
+	{1480008, {9826, -7936, 7691, 29241}},
+	{1489976, {10062, -7970, 7661, 29160}},
+	{1500202, {10291, -8004, 7629, 29079}},
+	{1509935, {10510, -8039, 7597, 28999}},
+	{1519880, {10719, -8072, 7565, 28922}},
+	{1530251, {10917, -8102, 7533, 28847}},
+	{1540082, {11104, -8130, 7502, 28776}},
+	{1549929, {11279, -8154, 7471, 28709}},
+	{1560088, {11441, -8172, 7442, 28647}},
+	{1569881, {11589, -8186, 7415, 28591}},
+	{1580082, {11724, -8193, 7389, 28541}},
+	{1590262, {11844, -8193, 7366, 28497}},
+	{1600216, {11949, -8186, 7345, 28460}},
+	{1610149, {12039, -8172, 7326, 28431}},
+	{1619975, {12114, -8151, 7311, 28410}},
+	{1630017, {12174, -8122, 7298, 28396}},
+	{1639937, {12217, -8086, 7288, 28390}},
+	{1650179, {12245, -8043, 7280, 28392}},
+	{1660084, {12257, -7992, 7276, 28402}},
+	{1670182, {12253, -7936, 7273, 28420}},
+	{1680002, {12234, -7874, 7273, 28446}},
+	{1689960, {12200, -7807, 7275, 28479}},
+	{1700195, {12150, -7736, 7279, 28519}},
+	{1710264, {12085, -7661, 7283, 28565}},
+	{1720212, {12006, -7584, 7289, 28617}},
+	{1730193, {11913, -7505, 7296, 28675}},
+	{1740198, {11806, -7427, 7302, 28738}},
+	{1750166, {11686, -7349, 7308, 28806}},
+	{1759961, {11554, -7273, 7313, 28877}},
+	{1770078, {11410, -7200, 7318, 28951}},
+	{1780013, {11254, -7132, 7320, 29028}},
+	{1789882, {11088, -7069, 7321, 29107}},
+	{1799882, {10913, -7013, 7319, 29187}},
+	{1809982, {10728, -6964, 7315, 29268}},
+	{1819974, {10535, -6924, 7308, 29350}},
+	{1830148, {10334, -6894, 7298, 29431}},
+	{1840253, {10127, -6874, 7284, 29510}},
+	{1850049, {9914, -6865, 7268, 29589}},
+	{1860245, {9695, -6868, 7248, 29665}},
+	{1870266, {9472, -6884, 7224, 29740}},
+	{1880253, {9246, -6911, 7197, 29811}},
+	{1890016, {9017, -6952, 7167, 29879}},
+	{1899959, {8785, -7005, 7134, 29943}},
+	{1909961, {8552, -7072, 7098, 30003}},
+	{1919949, {8319, -7150, 7059, 30060}},
+	{1929952, {8085, -7241, 7018, 30111}},
+	{1940120, {7852, -7343, 6975, 30158}},
+	{1950231, {7621, -7455, 6931, 30200}},
+	{1960207, {7391, -7578, 6885, 30237}},
+	{1970062, {7163, -7710, 6838, 30269}},
+	{1980132, {6939, -7849, 6792, 30296}},
+	{1990190, {6718, -7995, 6745, 30318}},
+};
+
+static const struct orientation_sample stream_1[] = {
+	{0, {0, 0, 0, 32767}},
+	{10231, {2, 1, 4, 32767}},
+	{20330, {8, 4, 16, 32767}},
+	{30279, {19, 8, 36, 32767}},
+	{40267, {33, 15, 64, 32767}},
+	{50158, {50, 23, 100, 32767}},
+	{60038, {69, 32, 144, 32767}},
+	{70282, {91, 43, 196, 32767}},
+	{80100, {113, 55, 257, 32767}},
+	{90287, {136, 67, 325, 32766}},
+	{100355, {158, 81, 401, 32765}},
+	{110125, {179, 95, 486, 32764}},
+	{120127, {198, 109, 578, 32762}},
+	{130345, {215, 123, 678, 32760}},
+	{140256, {228, 136, 786, 32757}},
+	{150035, {237, 149, 902, 32754}},
+	{160017, {242, 161, 1026, 32751}},
+	{170027, {243, 172, 1158, 32746}},
+	{180328, {240, 181, 1298, 32741}},
+	{190289, {233, 189, 1445, 32735}},
+	{200025, {222, 195, 1600, 32728}},
+	{210297, {208, 199, 1762, 32719}},
+	{220359, {191, 202, 1933, 32710}},
+	{230229, {171, 202, 2110, 32699}},
+	{240107, {151, 200, 2296, 32687}},
+	{250186, {129, 197, 2488, 32673}},
+	{260019, {108, 191, 2688, 32657}},
+	{269972, {88, 184, 2896, 32639}},
+	{280355, {69, 175, 3110, 32620}},
+	{290226, {53, 164, 3332, 32598}},
+	{300177, {40, 153, 3560, 32574}},
+	{310340, {31, 140, 3796, 32547}},
+	{320140, {25, 127, 4038, 32518}},
+	{330315, {24, 113, 4288, 32486}},
+	{340297, {28, 100, 4544, 32451}},
+	{350051, {35, 86, 4806, 32413}},
+	{360067, {47, 73, 5075, 32372}},
+	{370084, {62, 61, 5351, 32328}},
+	{380063, {81, 49, 5632, 32280}},
+	{390201, {102, 38, 5920, 32229}},
+	{400070, {125, 29, 6214, 32173}},
+	{410134, {150, 21, 6514, 32114}},
+	{420019, {174, 13, 6819, 32050}},
+	{430331, {199, 8, 7131, 31982}},
+	{440108, {221, 3, 7447, 31910}},
+	{450150, {242, 0, 7769, 31833}},
+	{460200, {259, -2, 8096, 31751}},
+	{470328, {274, -4, 8428, 31664}},
+	{480135, {284, -4, 8765, 31573}},
+	{490334, {289, -4, 9107, 31476}},
+	{500167, {291, -3, 9453, 31373}},
+	{510179, {287, -2, 9821, 31260}},
+	{520176, {278, -1, 10176, 31147}},
+	{529974, {266, 1, 10535, 31027}},
+	{540143, {249, 3, 10897, 30902}},
+	{550040, {229, 5, 11264, 30770}},
+	{559968, {206, 7, 11633, 30633}},
+	{570286, {182, 9, 12005, 30489}},
+	{580035, {156, 11, 12381, 30339}},
+	{590156, {129, 14, 12759, 30182}},
+	{600257, {103, 17, 13139, 30018}},
+	{610189, {79, 20, 13522, 29848}},
+	{620097, {56, 24, 13907, 29671}},
+	{630174, {36, 28, 14293, 29486}},
+	{640189, {20, 33, 14681, 29295}},
+	{650280, {7, 39, 15070, 29097}},
+	{660009, {-1, 46, 15461, 28891}},
+	{670191, {-5, 53, 15852, 28679}},
+	{680066, {-5, 61, 16243, 28459}},
+	{690077, {0, 70, 16635, 28231}},
+	{700275, {10, 79, 17027, 27997}},
+	{710170, {23, 88, 17419, 27755}},
+	{720191, {40, 97, 17810, 27505}},
+	{730270, {59, 106, 18201, 27248}},
+	{740331, {81, 114, 18590, 26984}},
+	{750144, {105, 121, 18979, 26712}},
+	{760212, {129, 127, 19365, 26433}},
+	{770169, {154, 130, 19750, 26146}},
+	{780171, {178, 132, 20134, 25852}},
+	{790244, {202, 132, 20514, 25551}},
+	{800147, {223, 128, 20893, 25242}},
+	{810180, {242, 122, 21268, 24926}},
+	{820158, {259, 113, 21641, 24603}},
+	{830343, {273, 100, 22010, 24274}},
+	{840246, {283, 85, 22376, 23937}},
+	{850317, {290, 67, 22738, 23593}},
+	{860343, {294, 46, 23097, 23242}},
+	{870070, {295, 23, 23451, 22885}},
+	{880190, {293, -1, 23800, 22521}},
+	{890344, {288, -27, 24146, 22151}},
+	{900302, {280, -54, 24486, 21774}},
+	{910021, {271, -80, 24821, 21391}},
+	{920015, {260, -106, 25151, 21002}},
+	{930143, {247, -131, 25475, 20608}},
+	{939996, {234, -153, 25794, 20207}},
+	{950063, {221, -173, 26107, 19801}},
+	{959996, {207, -190, 26414, 19390}},
+	{970234, {194, -203, 26715, 18973}},
+	{980280, {181, -212, 27009, 18552}},
+	{990325, {170, -216, 27297, 18125}},
+	{1000028, {159, -217, 27579, 17694}},
+	{1010253, {149, -212, 27853, 17259}},
+	{1020231, {140, -203, 28121, 16820}},
+	{1030024, {132, -191, 28381, 16376}},
+	{1040320, {125, -174, 28635, 15929}},
+	{1050354, {119, -154, 28881, 15479}},
+	{1060054, {113, -132, 29120, 15025}},
+	{1070348, {108, -108, 29351, 14568}},
+	{1080126, {104, -84, 29575, 14108}},
+	{1090161, {100, -58, 29791, 13646}},
+	{1100362, {96, -34, 30000, 13182}},
+	{1110299, {92, -11, 30200, 12715}},
+	{1120031, {88, 9, 30393, 12247}},
+	{1130139, {84, 27, 30578, 11777}},
+	{1140173, {80, 41, 30755, 11307}},
+	{1150102, {76, 51, 30925, 10835}},
+	{1160045, {73, 56, 31086, 10362}},
+	{1170094, {69, 57, 31240, 9889}},
+	{1180255, {66, 54, 31386, 9416}},
+	{1189974, {64, 45, 31524, 8942}},
+	{1200188, {62, 33, 31655, 8469}},
+	{1210143, {62, 17, 31777, 7997}},
+	{1219974, {62, -3, 31892, 7525}},
+	{1230099, {63, -25, 32000, 7054}},
+	{1240216, {66, -49, 32099, 6585}},
+	{1250171, {70, -74, 32192, 6117}},
+	{1259992, {75, -100, 32277, 5651}},
+	{1270361, {82, -124, 32355, 5187}},
+	{1280282, {89, -148, 32425, 4725}},
+	{1290355, {98, -169, 32489, 4265}},
+	{1300008, {108, -187, 32545, 3808}},
+	{1310073, {118, -201, 32595, 3354}},
+	{1319982, {129, -212, 32638, 2903}},
+	{1330278, {139, -218, 32675, 2456}},
+	{1340075, {150, -220, 32705, 2012}},
+	{1350018, {160, -218, 32729, 1572}},
+	{1360135, {169, -212, 32747, 1135}},
+	{1370331, {177, -201, 32759, 703}},
+	{1380294, {184, -188, 32766, 275}},
+	{1390070, {190, -171, 32767, -148}},
+	{1400026, {193, -152, 32762, -567}},
+	{1410334, {195, -133, 32752, -981}},
+	{1420195, {196, -112, 32738, -1390}},
+	{1430247, {194, -92, 32718, -1794}},
+	{1440002, {190, -73, 32694, -2192}},
+	{1449990, {185, -56, 32665, -2585}},
+	{1460242, {178, -41, 32632, -2972}},
+	{1470137, {170, -30, 32595, -3354}},
+	{1479995, {160, -23, 32555, -3730}},
+	{1490342, {149, -20, 32510, -4099}},
+	{1500220, {138, -21, 32462, -4463}},
+	{1510287, {126, -26, 32411, -4820}},
+	{1520000, {114, -36, 32357, -5171}},
+	{1530309, {102, -49, 32300, -5515}},
+	{1539993, {90, -67, 32241, -5853}},
+	{1550312, {78, -87, 32179, -6185}},
+	{1560148, {67, -110, 32115, -6509}},
+	{1570102, {56, -134, 32049, -6827}},
+	{1580188, {47, -160, 31981, -7138}},
+	{1590337, {38, -185, 31911, -7443}},
+	{1600074, {30, -210, 31840, -7740}},
+	{1610018, {23, -233, 31768, -8030}},
+	{1620177, {17, -254, 31695, -8313}},
+	{1630062, {12, -271, 31621, -8589}},
+	{1640010, {7, -285, 31547, -8858}},
+	{1650031, {3, -295, 31472, -9120}},
+	{1659987, {0, -300, 31397, -9374}},
+	{1670047, {-2, -301, 31322, -9622}},
+	{1680091, {-4, -297, 31247, -9862}},
+	{1690089, {-5, -288, 31173, -10094}},
+	{1700270, {-6, -275, 31099, -10320}},
+	{1710082, {-6, -259, 31026, -10538}},
+	{1720167, {-6, -239, 30954, -10748}},
+	{1730038, {-5, -216, 30883, -10951}},
+	{1740105, {-3, -192, 30813, -11147}},
+	{1749974, {0, -166, 30744, -11336}},
+	{1760067, {3, -140, 30677, -11517}},
+	{1769973, {8, -115, 30612, -11690}},
+	{1780260, {13, -91, 30548, -11856}},
+	{1790187, {19, -69, 30486, -12015}},
+	{1800042, {27, -50, 30426, -12166}},
+	{1810156, {35, -34, 30368, -12310}},
+	{1820340, {44, -22, 30312, -12446}},
+	{1830009, {54, -15, 30259, -12575}},
+	{1840294, {65, -11, 30208, -12697}},
+	{1850139, {76, -12, 30160, -12811}},
+	{1860165, {88, -18, 30114, -12918}},
+	{1870300, {100, -27, 30071, -13017}},
+	{1880124, {111, -40, 30031, -13109}},
+	{1890169, {122, -56, 29994, -13193}},
+	{1900242, {132, -75, 29960, -13270}},
+	{1910359, {140, -96, 29929, -13340}},
+	{1920104, {148, -118, 29901, -13402}},
+	{1930299, {153, -140, 29876, -13457}},
+	{1940249, {157, -162, 29855, -13505}},
+	{1950221, {158, -183, 29837, -13545}},
+	{1960128, {157, -203, 29822, -13578}},
+	{1970106, {153, -220, 29810, -13603}},
+	{1979988, {147, -234, 29802, -13621}},
+	{1990018, {138, -245, 29797, -13632}},
+};
+
+static const struct orientation_stream streams[] = {
+	{stream_0, ARRAY_SIZE(stream_0)},
+	{stream_1, ARRAY_SIZE(stream_1)},
+};